@@ -0,0 +1,149 @@
+#pragma once
+
+#include "par_loop.h"
+#include "sculpture.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+// Per-instance GPU state: (gy, spin, scale, animTime) at both ends of the
+// window the vertex shader interpolates across.
+struct InstanceState { glm::vec4 s0, s1; };
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Animation LOD
+//  Every region gets an update interval from the projected size of one of its
+//  cubes. Due regions are refreshed round-robin until the per-frame budget of
+//  cube evaluations runs out. A refresh evaluates the cube one interval ahead,
+//  so the shader can interpolate from where it is now to where it will be.
+// ─────────────────────────────────────────────────────────────────────────────
+class AnimLod {
+public:
+    static const int MAX_INTERVAL = 16;
+    float fullRatePx = 24.f;        // cubes at least this tall update every frame
+    int   budget = 0;               // cube evaluations per frame, 0 = unlimited
+
+    std::vector<InstanceState, FirstTouchAllocator<InstanceState>> states;
+    int dirtyLo = 0, dirtyHi = 0;           // instance range written by the last update
+    long long evaluated = 0, possible = 0;  // running totals for reporting
+
+    // The state array is first written by the pool participant whose
+    // parallelFor slice it is, which puts its pages on that participant's
+    // node when the pool is pinned
+    AnimLod(const SculptureGrid& g, WorkerPool& pool)
+        : states(g.count()), g(g), lastUpdate(g.regions(), -MAX_INTERVAL), interval(g.regions(), 1)
+    {
+        pool.parallelFor(0, g.count(), [&](int lo, int hi, unsigned) {
+            for (int i = lo; i < hi; i++) states[i] = InstanceState{};
+        });
+    }
+
+    // eval(lo, hi, t, out) writes the CubeStates of instances [lo, hi) at
+    // animation time t to out[0, hi - lo). animStep is how far animTime moved
+    // this frame (0 while paused).
+    template <class Eval>
+    void update(Eval&& eval, float now, float animStep, bool enabled,
+                glm::vec3 camPos, glm::vec3 camFront, float fovY, int screenH)
+    {
+        if (animStep <= 0) stepEst = 0;
+        else stepEst = stepEst > 0 ? stepEst * 0.9f + animStep * 0.1f : animStep;
+
+        int n = g.regions();
+        float pxPerUnit = screenH / (2.f * tanf(glm::radians(fovY) * 0.5f));
+        for (int r = 0; r < n; r++) {
+            if (!enabled) { interval[r] = 1; continue; }
+            glm::vec3 v = g.regionCentre[r] - camPos;
+            float depth = glm::dot(v, camFront);
+            if (depth < -g.regionRadius) { interval[r] = MAX_INTERVAL; continue; }
+            float px = g.spacing * pxPerUnit / std::max(glm::length(v) - g.regionRadius, 1.f);
+            interval[r] = std::clamp((int)ceilf(fullRatePx / px), 1, MAX_INTERVAL);
+        }
+
+        int limit = enabled && budget > 0 ? budget : INT_MAX, spent = 0;
+        dirtyLo = g.count(); dirtyHi = 0;
+        for (int k = 0; k < n; k++) {
+            int r = (cursor + k) % n;
+            if (frame - lastUpdate[r] < interval[r]) continue;
+            int lo = g.regionStart[r], hi = g.regionStart[r + 1];
+            if (spent > 0 && spent + (hi - lo) > limit) { cursor = r; break; }
+            refresh(eval, lo, hi, now, interval[r], lastUpdate[r] < 0);
+            lastUpdate[r] = frame;
+            spent += hi - lo;
+            dirtyLo = std::min(dirtyLo, lo); dirtyHi = std::max(dirtyHi, hi);
+        }
+        evaluated += spent;
+        possible += g.count();
+        frame++;
+    }
+
+    // Without LOD: every cube at now, written by cube(i) -> CubeState, which
+    // must be safe to call concurrently; exec picks how the loop runs.
+    // Same states and bookkeeping as update() with LOD disabled.
+    template <class Cube>
+    void updateAll(Cube&& cube, float now, float animStep, LoopExec exec, WorkerPool& pool)
+    {
+        if (animStep <= 0) stepEst = 0;
+        else stepEst = stepEst > 0 ? stepEst * 0.9f + animStep * 0.1f : animStep;
+
+        forEachElement(exec, pool, states, [&](InstanceState& st, int i) {
+            CubeState c = cube(i);
+            st.s0 = st.s1 = glm::vec4(c.gy, c.spin, c.s, now);
+        });
+        std::fill(interval.begin(), interval.end(), 1);
+        std::fill(lastUpdate.begin(), lastUpdate.end(), frame);
+        dirtyLo = 0; dirtyHi = g.count();
+        evaluated += g.count();
+        possible += g.count();
+        frame++;
+    }
+
+    float savedPercent() const { return possible ? 100.f * (1.f - (float)evaluated / possible) : 0.f; }
+    void  resetStats() { evaluated = possible = 0; }
+
+private:
+    template <class Eval>
+    void refresh(Eval& eval, int lo, int hi, float now, int k, bool first)
+    {
+        float t1 = k > 1 ? now + k * stepEst : now;
+        next.resize(hi - lo);
+        eval(lo, hi, t1, next.data());
+        bool ahead = t1 > now;
+        if (ahead && first) {
+            cur.resize(hi - lo);
+            eval(lo, hi, now, cur.data());
+        }
+        for (int i = lo; i < hi; i++) {
+            InstanceState& st = states[i];
+            const CubeState& c = next[i - lo];
+            if (!ahead)
+                st.s0 = glm::vec4(c.gy, c.spin, c.s, now);
+            else if (first) {
+                const CubeState& c0 = cur[i - lo];
+                st.s0 = glm::vec4(c0.gy, c0.spin, c0.s, now);
+            }
+            else
+                st.s0 = glm::vec4(current(st, now), now);
+            st.s1 = glm::vec4(c.gy, c.spin, c.s, t1);
+        }
+    }
+
+    // Same interpolation as the vertex shader
+    static glm::vec3 current(const InstanceState& st, float t)
+    {
+        float span = st.s1.w - st.s0.w;
+        float f = span > 0 ? std::clamp((t - st.s0.w) / span, 0.f, 1.f) : 1.f;
+        return glm::vec3(st.s0) + (glm::vec3(st.s1) - glm::vec3(st.s0)) * f;
+    }
+
+    const SculptureGrid& g;
+    std::vector<long long> lastUpdate;
+    std::vector<int> interval;
+    std::vector<CubeState> next, cur;   // one region's evaluations
+    long long frame = 0;
+    int   cursor = 0;
+    float stepEst = 0;
+};
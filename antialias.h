@@ -0,0 +1,201 @@
+#pragma once
+
+#include "gl_util.h"
+
+#include <algorithm>
+#include <string>
+
+enum class AaMode { None, Taa, Msaa4, Msaa8 };
+
+inline const char* aaName(AaMode m)
+{
+    switch (m) {
+    case AaMode::Taa:   return "taa";
+    case AaMode::Msaa4: return "msaa4";
+    case AaMode::Msaa8: return "msaa8";
+    default:            return "none";
+    }
+}
+
+// out is left alone if s names no mode
+inline bool parseAa(const std::string& s, AaMode& out)
+{
+    for (AaMode m : { AaMode::None, AaMode::Taa, AaMode::Msaa4, AaMode::Msaa8 })
+        if (s == aaName(m)) { out = m; return true; }
+    return false;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Temporal anti-aliasing
+//  The projection is jittered by a Halton(2,3) sub-pixel offset each frame;
+//  the resolve reprojects the accumulated history with the scene's velocity
+//  buffer (taking the nearest surface in a 3x3 neighbourhood so edges carry
+//  their own motion), clamps it to the current 3x3 colour range in YCoCg and
+//  blends in 10% of the new frame.
+// ─────────────────────────────────────────────────────────────────────────────
+static const char* TAA_FRAG = R"GLSL(
+#version 330 core
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D current;      // rgb = colour, a = view depth (0 = background)
+uniform sampler2D velocity;
+uniform sampler2D history;
+uniform vec2      texel;
+uniform bool      historyValid;
+
+vec3 toYCoCg(vec3 c) { return vec3(dot(c, vec3(0.25, 0.5, 0.25)), dot(c, vec3(0.5, 0.0, -0.5)), dot(c, vec3(-0.25, 0.5, -0.25))); }
+vec3 toRgb(vec3 c)   { return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z); }
+
+void main()
+{
+    vec3  cur  = toYCoCg(texture(current, uv).rgb);
+    vec3  lo   = cur, hi = cur;
+    vec2  best = uv;
+    float near = 1e30;
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++) {
+            vec2 o = uv + vec2(x, y) * texel;
+            vec4 s = texture(current, o);
+            vec3 c = toYCoCg(s.rgb);
+            lo = min(lo, c); hi = max(hi, c);
+            if (s.a > 0.0 && s.a < near) { near = s.a; best = o; }
+        }
+
+    vec2 prev = uv - texture(velocity, best).xy;
+    float a = 0.1;
+    if (!historyValid || any(lessThan(prev, vec2(0.0))) || any(greaterThan(prev, vec2(1.0)))) a = 1.0;
+
+    vec3 h = clamp(toYCoCg(texture(history, prev).rgb), lo, hi);
+    FragColor = vec4(toRgb(mix(h, cur, a)), 1.0);
+}
+)GLSL";
+
+class Taa {
+public:
+    void init(int w, int h)
+    {
+        width = w; height = h;
+        for (int i = 0; i < 2; i++) {
+            colour[i] = makeTexture(w, h, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+            fbo[i] = makeFramebuffer({ colour[i] }, 0);
+        }
+        prog = makeProgram(FULLSCREEN_VERT, TAA_FRAG);
+    }
+
+    void destroy()
+    {
+        glDeleteFramebuffers(2, fbo);
+        glDeleteTextures(2, colour);
+        glDeleteProgram(prog);
+    }
+
+    // Sub-pixel offset for this frame, to add to projection[2].xy
+    glm::vec2 jitter() const
+    {
+        int i = (int)(frame % 8) + 1;
+        return { (halton(i, 2) - 0.5f) * 2.f / width, (halton(i, 3) - 0.5f) * 2.f / height };
+    }
+
+    void resolve(GLuint current, GLuint velocity, GLuint emptyVAO)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo[cur]);
+        glViewport(0, 0, width, height);
+        glState().useProgram(prog);
+        const GLuint tex[3] = { current, velocity, colour[cur ^ 1] };
+        for (int i = 0; i < 3; i++) {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, tex[i]);
+        }
+        setInt(prog, "current", 0);
+        setInt(prog, "velocity", 1);
+        setInt(prog, "history", 2);
+        setVec2(prog, "texel", { 1.f / width, 1.f / height });
+        setInt(prog, "historyValid", valid ? 1 : 0);
+        glDisable(GL_DEPTH_TEST);
+        drawFullscreen(emptyVAO);
+        glEnable(GL_DEPTH_TEST);
+        glActiveTexture(GL_TEXTURE0);
+        cur ^= 1; frame++; valid = true;
+    }
+
+    void   invalidate() { valid = false; }
+    GLuint output() const { return colour[cur ^ 1]; }
+    GLuint outputFbo() const { return fbo[cur ^ 1]; }
+
+private:
+    static float halton(int i, int b)
+    {
+        float f = 1, r = 0;
+        for (; i > 0; i /= b) { f /= b; r += f * (i % b); }
+        return r;
+    }
+
+    int    width = 0, height = 0, cur = 0;
+    unsigned frame = 0;
+    bool   valid = false;
+    GLuint colour[2] = {}, fbo[2] = {}, prog = 0;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Multisampled scene target, resolved into a single-sample texture
+// ─────────────────────────────────────────────────────────────────────────────
+class MsaaTarget {
+public:
+    void init(int w, int h, int samples)
+    {
+        width = w; height = h; want = samples;
+        GLint maxSamples = 1;
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+        count = std::min(samples, (int)maxSamples);
+
+        glGenRenderbuffers(2, rb);
+        glBindRenderbuffer(GL_RENDERBUFFER, rb[0]);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, count, GL_RGBA16F, w, h);
+        glBindRenderbuffer(GL_RENDERBUFFER, rb[1]);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, count, GL_DEPTH_COMPONENT24, w, h);
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rb[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rb[1]);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "[FBO ERROR] incomplete multisample framebuffer\n";
+
+        resolved = makeTexture(w, h, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        resolveFbo = makeFramebuffer({ resolved }, 0);
+    }
+
+    void destroy()
+    {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteFramebuffers(1, &resolveFbo);
+        glDeleteRenderbuffers(2, rb);
+        glDeleteTextures(1, &resolved);
+    }
+
+    void begin(glm::vec3 clearColour)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        glClearColor(clearColour.x, clearColour.y, clearColour.z, 1);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    void resolve()
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFbo);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    bool   ready() const { return fbo != 0; }
+    int    requested() const { return want; }
+    int    samples() const { return count; }
+    GLuint output() const { return resolved; }
+    GLuint outputFbo() const { return resolveFbo; }
+
+private:
+    int    width = 0, height = 0, want = 0, count = 0;
+    GLuint fbo = 0, rb[2] = {}, resolved = 0, resolveFbo = 0;
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "command_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef __cpp_impl_coroutine
+#error "async_task.h needs C++20 coroutines: build with -std=c++20"
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Tasks
+//  Task<T> is a coroutine that starts when first awaited and resumes its
+//  awaiter when it finishes, so loads compose with co_await. Errors are
+//  results (an empty value, a zero handle), not exceptions.
+// ─────────────────────────────────────────────────────────────────────────────
+template <class T = void> class Task;
+
+namespace task_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+
+    struct Final {
+        bool await_ready() noexcept { return false; }
+        template <class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+            std::coroutine_handle<> c = h.promise().continuation;
+            return c ? c : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    Final final_suspend() noexcept { return {}; }
+    void unhandled_exception() { std::terminate(); }
+};
+
+template <class T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+    Task<T> get_return_object();
+    void return_value(T v) { value = std::move(v); }
+    T result() { return std::move(*value); }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void result() {}
+};
+
+} // namespace task_detail
+
+template <class T>
+class Task {
+public:
+    using promise_type = task_detail::Promise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> h) : h(h) {}
+    Task(Task&& o) noexcept : h(std::exchange(o.h, {})) {}
+    Task& operator=(Task&& o) noexcept { if (this != &o) { if (h) h.destroy(); h = std::exchange(o.h, {}); } return *this; }
+    ~Task() { if (h) h.destroy(); }
+
+    bool await_ready() const { return !h || h.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+    {
+        h.promise().continuation = awaiting;
+        return h;
+    }
+    T await_resume() { return h.promise().result(); }
+
+private:
+    std::coroutine_handle<promise_type> h;
+};
+
+template <class T>
+Task<T> task_detail::Promise<T>::get_return_object() { return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this)); }
+inline Task<void> task_detail::Promise<void>::get_return_object() { return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this)); }
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Async loader
+//  Where a task runs is its own choice: co_await background() moves it to
+//  one of the loader's IO threads (file reads, decoding), co_await
+//  glThread() moves it back to the thread that calls pump() once a frame,
+//  which is the only one allowed to touch GL. spawn() starts a task without
+//  waiting for it; whatever it produces it stores itself, and the frame
+//  that finds it still missing draws with a placeholder.
+//  Call wait() before the GL context goes away: tasks still queued for the
+//  GL thread are not run after that, and the destructor frees whatever has
+//  not finished without running it.
+// ─────────────────────────────────────────────────────────────────────────────
+class AsyncLoader {
+public:
+    explicit AsyncLoader(unsigned threads = 2)
+    {
+        for (unsigned i = 0; i < std::max(1u, threads); i++)
+            workers.emplace_back([this] { loop(); });
+    }
+
+    // Tasks still running are freed, not finished: once the IO threads are
+    // done, each spawned task's frame is destroyed, and with it the tasks it
+    // awaits and their locals (mapped files and all)
+    ~AsyncLoader()
+    {
+        stopping.store(true, std::memory_order_release);
+        { std::lock_guard<std::mutex> l(m); quit = true; }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+        std::coroutine_handle<> h;
+        while (glQueue.pop(h)) {}
+        std::set<void*> left;
+        { std::lock_guard<std::mutex> l(rootsLock); left.swap(roots); }
+        for (void* p : left) std::coroutine_handle<>::from_address(p).destroy();
+    }
+
+    AsyncLoader(const AsyncLoader&) = delete;
+    AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+    struct Background {
+        AsyncLoader& loader;
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> h) { loader.post(h); }
+        void await_resume() const {}
+    };
+
+    struct GlThread {
+        AsyncLoader& loader;
+        bool await_ready() const { return false; }
+        // While the loader shuts down nothing pops glQueue, so h is left
+        // suspended instead; the destructor frees it with its root
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            while (!loader.stopping.load(std::memory_order_acquire) && !loader.glQueue.push(h)) std::this_thread::yield();
+        }
+        void await_resume() const {}
+    };
+
+    Background background() { return { *this }; }
+    GlThread   glThread() { return { *this }; }
+
+    // Runs t up to its first suspension on this thread, the rest wherever
+    // it moves itself
+    void spawn(Task<void> t)
+    {
+        pendingTasks.fetch_add(1);
+        run(std::move(t), this);
+    }
+
+    int pending() const { return pendingTasks.load(); }
+
+    // GL thread: resumes queued tasks until the queue is empty or budgetMs
+    // has passed (at least one runs). Returns how many ran.
+    int pump(double budgetMs)
+    {
+        using clk = std::chrono::steady_clock;
+        auto t0 = clk::now();
+        int n = 0;
+        std::coroutine_handle<> h;
+        while (glQueue.pop(h)) {
+            h.resume();
+            n++;
+            if (std::chrono::duration<double, std::milli>(clk::now() - t0).count() >= budgetMs) break;
+        }
+        return n;
+    }
+
+    // GL thread: pumps without a budget until every spawned task is done
+    void wait()
+    {
+        while (pending() > 0)
+            if (!pump(1e9)) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+private:
+    // Owns a spawned task: starts at once and frees itself when done. Listed
+    // in roots while it lives, so the loader can free it early.
+    struct Detached {
+        struct promise_type {
+            AsyncLoader& loader;
+            promise_type(Task<void>&, AsyncLoader* self) : loader(*self)
+            {
+                std::lock_guard<std::mutex> l(loader.rootsLock);
+                loader.roots.insert(std::coroutine_handle<promise_type>::from_promise(*this).address());
+            }
+            ~promise_type()
+            {
+                std::lock_guard<std::mutex> l(loader.rootsLock);
+                loader.roots.erase(std::coroutine_handle<promise_type>::from_promise(*this).address());
+            }
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    static Detached run(Task<void> t, AsyncLoader* self)
+    {
+        co_await t;
+        self->pendingTasks.fetch_sub(1);
+    }
+
+    void post(std::coroutine_handle<> h)
+    {
+        { std::lock_guard<std::mutex> l(m); ioQueue.push_back(h); }
+        wake.notify_one();
+    }
+
+    void loop()
+    {
+        for (;;) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> l(m);
+                wake.wait(l, [&] { return quit || !ioQueue.empty(); });
+                if (ioQueue.empty()) return;
+                h = ioQueue.front();
+                ioQueue.pop_front();
+            }
+            h.resume();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable wake;
+    std::deque<std::coroutine_handle<>> ioQueue;
+    bool quit = false;
+    std::atomic<bool> stopping{ false };    // set before quit: no more hops to the GL thread
+    MpscQueue<std::coroutine_handle<>, 256> glQueue;    // pushed by any thread, popped by pump()
+    std::atomic<int> pendingTasks{ 0 };
+    std::mutex rootsLock;
+    std::set<void*> roots;          // frames of spawned tasks not yet finished
+};
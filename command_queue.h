@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Bounded MPSC queue
+//  Any number of threads push; one thread (the render loop) pops. Lock-free
+//  ring of N cells, each with a sequence number saying whose turn it is:
+//  seq == pos means free for the producer that claims position pos, seq ==
+//  pos + 1 means filled for the consumer. Producers claim a position with a
+//  CAS on the tail and publish by storing seq; the consumer owns the head
+//  and needs no atomics beyond the cell's seq. A full queue rejects the push
+//  (counted in dropped()) instead of blocking. Items from one producer come
+//  out in the order it pushed them.
+// ─────────────────────────────────────────────────────────────────────────────
+template <class T, size_t N>
+class MpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+public:
+    using value_type = T;
+
+    MpscQueue()
+    {
+        for (size_t i = 0; i < N; i++) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    static constexpr size_t capacity() { return N; }
+
+    // Any thread; false if the queue is full
+    bool push(const T& v)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells[pos & (N - 1)];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)(seq - pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = v;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {        // the consumer has not freed this cell yet
+                rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+                pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer only; false if nothing is ready. An item whose producer has
+    // claimed its cell but not yet published it ends the pop there.
+    bool pop(T& out)
+    {
+        Cell& c = cells[head & (N - 1)];
+        if (c.seq.load(std::memory_order_acquire) != head + 1) return false;
+        out = c.value;
+        c.seq.store(head + N, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    // Consumer only: fn(item) for what is ready now, at most one ring's worth
+    // so producers that keep pushing cannot hold the consumer here
+    template <class F>
+    size_t drain(F&& fn)
+    {
+        T v;
+        size_t n = 0;
+        while (n < N && pop(v)) { fn(v); n++; }
+        return n;
+    }
+
+    unsigned long long dropped() const { return rejected.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Cell {           // one cache line each, so producers
+        std::atomic<size_t> seq;        // filling neighbouring cells do not
+        T value;                        // share a line
+    };
+
+    Cell cells[N];
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    alignas(64) size_t head = 0;
+    alignas(64) std::atomic<unsigned long long> rejected{ 0 };
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Render-loop commands
+//  Input callbacks and anything else that wants to change what is drawn push
+//  these; the render loop applies them once per frame, so camera and
+//  animation state are only ever written on the render thread.
+// ─────────────────────────────────────────────────────────────────────────────
+struct Command {
+    enum Type : uint8_t {
+        Quit, MoveForward, MoveBackward, MoveLeft, MoveRight, Look, Zoom,
+        TogglePause, ToggleWave, DropWave, ToggleLod, ToggleCache, CycleAa, CycleLightingScale
+    };
+    static const int TYPES = CycleLightingScale + 1;
+
+    Type  type;
+    float a = 0, b = 0;     // move: dt; look: dx, dy; zoom: scroll offset
+
+    // Quit and the toggles carry nothing and must not be lost
+    static bool keep(Type t) { return t == Quit || t >= TogglePause; }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Command queue
+//  MpscQueue of Commands that never loses a kept one: when the ring is full
+//  it is counted per type instead, and drain() hands it out after what the
+//  ring held. Moves, looks and zooms that do not fit are dropped (and
+//  counted in dropped()): the next frame's input supersedes them.
+// ─────────────────────────────────────────────────────────────────────────────
+template <size_t N>
+class CommandQueue {
+public:
+    // Any thread; false if c was dropped
+    bool push(const Command& c)
+    {
+        if (ring.push(c)) return true;
+        if (!Command::keep(c.type)) { lost.fetch_add(1, std::memory_order_relaxed); return false; }
+        overflow[c.type].fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, as MpscQueue::drain
+    template <class F>
+    size_t drain(F&& fn)
+    {
+        size_t n = ring.drain(fn);
+        for (int t = 0; t < Command::TYPES; t++)
+            for (unsigned k = overflow[t].exchange(0, std::memory_order_acquire); k; k--, n++) fn(Command{ (Command::Type)t });
+        return n;
+    }
+
+    unsigned long long dropped() const { return lost.load(std::memory_order_relaxed); }
+
+private:
+    MpscQueue<Command, N> ring;
+    std::atomic<unsigned> overflow[Command::TYPES] = {};
+    std::atomic<unsigned long long> lost{ 0 };
+};
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  CPU topology
+//  The CPUs this process may run on, with the core, package and NUMA node of
+//  each, read from sysfs on Linux. Elsewhere (or without sysfs) every CPU is
+//  its own core on node 0 and nothing gets pinned.
+// ─────────────────────────────────────────────────────────────────────────────
+struct CpuInfo { int cpu, core, package, node; };   // core: index into the distinct (package, core_id)
+
+struct CpuTopology {
+    std::vector<CpuInfo> cpus;      // sorted by node, package, core, cpu
+    int nodes = 1, packages = 1, cores = 0;
+
+    static CpuTopology detect()
+    {
+        CpuTopology t;
+        std::vector<int> ids;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof set, &set) == 0)
+            for (int c = 0; c < CPU_SETSIZE; c++)
+                if (CPU_ISSET(c, &set)) ids.push_back(c);
+#endif
+        if (ids.empty())
+            for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); c++) ids.push_back((int)c);
+
+        std::map<int, int> nodeOf;
+        std::string online, list;
+        if (readLine("/sys/devices/system/node/online", online))
+            for (int n : parseList(online))
+                if (readLine("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist", list))
+                    for (int c : parseList(list)) nodeOf[c] = n;
+
+        std::map<std::pair<int, int>, int> coreIndex;
+        for (int c : ids) {
+            std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/", s;
+            int pkg = readLine(dir + "physical_package_id", s) ? std::max(0, atoi(s.c_str())) : 0;
+            int core = readLine(dir + "core_id", s) ? atoi(s.c_str()) : c;
+            auto key = std::make_pair(pkg, core);
+            if (!coreIndex.count(key)) coreIndex.emplace(key, (int)coreIndex.size());
+            auto n = nodeOf.find(c);
+            t.cpus.push_back({ c, coreIndex[key], pkg, n != nodeOf.end() ? n->second : 0 });
+        }
+        std::sort(t.cpus.begin(), t.cpus.end(), [](const CpuInfo& a, const CpuInfo& b) {
+            return std::make_tuple(a.node, a.package, a.core, a.cpu) < std::make_tuple(b.node, b.package, b.core, b.cpu);
+        });
+
+        std::vector<int> nodeIds, pkgIds;
+        for (const CpuInfo& c : t.cpus) { nodeIds.push_back(c.node); pkgIds.push_back(c.package); }
+        t.nodes = distinct(nodeIds);
+        t.packages = distinct(pkgIds);
+        t.cores = (int)coreIndex.size();
+        return t;
+    }
+
+    int nodeOf(int cpu) const
+    {
+        for (const CpuInfo& c : cpus) if (c.cpu == cpu) return c.node;
+        return 0;
+    }
+
+    // One CPU per pool participant, participant 0 (the calling, GL-owning
+    // thread, left unpinned) first on the first core. Node by node, one
+    // thread per core before SMT siblings, so neighbouring slices of
+    // parallelFor share a node. The main thread's siblings get no worker: it
+    // keeps its core to itself.
+    std::vector<int> placement() const
+    {
+        std::vector<int> out;
+        if (cpus.empty()) return out;
+        const CpuInfo& main = cpus[0];
+        out.push_back(main.cpu);
+        for (size_t lo = 0; lo < cpus.size();) {
+            size_t hi = lo;
+            while (hi < cpus.size() && cpus[hi].node == cpus[lo].node) hi++;
+            for (int pass = 0; pass < 2; pass++)
+                for (size_t i = lo; i < hi; i++) {
+                    bool primary = i == 0 || cpus[i - 1].core != cpus[i].core;
+                    if (primary != (pass == 0) || cpus[i].cpu == main.cpu) continue;
+                    if (cpus[i].core == main.core && cores > 1) continue;
+                    out.push_back(cpus[i].cpu);
+                }
+            lo = hi;
+        }
+        return out;
+    }
+
+    std::string describe() const
+    {
+        return std::to_string(nodes) + (nodes == 1 ? " node, " : " nodes, ") + std::to_string(packages)
+            + (packages == 1 ? " package, " : " packages, ") + std::to_string(cores) + (cores == 1 ? " core, " : " cores, ")
+            + std::to_string(cpus.size()) + " CPUs usable";
+    }
+
+    // "0-3,8,10-11"
+    static std::string formatList(std::vector<int> ids)
+    {
+        std::sort(ids.begin(), ids.end());
+        std::string s;
+        for (size_t i = 0; i < ids.size();) {
+            size_t j = i;
+            while (j + 1 < ids.size() && ids[j + 1] == ids[j] + 1) j++;
+            if (!s.empty()) s += ",";
+            s += std::to_string(ids[i]);
+            if (j > i) s += "-" + std::to_string(ids[j]);
+            i = j + 1;
+        }
+        return s;
+    }
+
+private:
+    static bool readLine(const std::string& path, std::string& out)
+    {
+        FILE* f = fopen(path.c_str(), "r");
+        if (!f) return false;
+        char buf[4096];
+        bool ok = fgets(buf, sizeof buf, f) != nullptr;
+        fclose(f);
+        if (ok) { out = buf; while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) out.pop_back(); }
+        return ok;
+    }
+
+    static std::vector<int> parseList(const std::string& s)
+    {
+        std::vector<int> ids;
+        int a, b, n;
+        for (const char* p = s.c_str(); *p; p += *p == ',') {
+            if (sscanf(p, "%d-%d%n", &a, &b, &n) == 2) p += n;
+            else if (sscanf(p, "%d%n", &a, &n) == 1) { b = a; p += n; }
+            else break;
+            for (int c = a; c <= b; c++) ids.push_back(c);
+        }
+        return ids;
+    }
+
+    static int distinct(std::vector<int> v)
+    {
+        std::sort(v.begin(), v.end());
+        return std::max(1, (int)(std::unique(v.begin(), v.end()) - v.begin()));
+    }
+};
+
+// Pins a thread to one CPU; false where unsupported or refused
+inline bool pinThread(std::thread::native_handle_type h, int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(h, sizeof set, &set) == 0;
+#else
+    (void)h; (void)cpu;
+    return false;
+#endif
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  First-touch allocation
+//  Linux places a page on the NUMA node of the thread that first writes it.
+//  This allocator maps fresh pages and leaves trivial elements uninitialised,
+//  so nothing is placed until the owner of each slice writes it (see the
+//  AnimLod constructor's parallelFor). Blocks are whole pages; use it for
+//  large arrays only.
+// ─────────────────────────────────────────────────────────────────────────────
+template <class T>
+struct FirstTouchAllocator {
+    using value_type = T;
+
+    FirstTouchAllocator() = default;
+    template <class U> FirstTouchAllocator(const FirstTouchAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+#ifdef __linux__
+        void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        return (T*)p;
+#else
+        return (T*)::operator new(n * sizeof(T));
+#endif
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+#ifdef __linux__
+        munmap(p, n * sizeof(T));
+#else
+        (void)n;
+        ::operator delete(p);
+#endif
+    }
+
+    // Default-initialise: no writes for trivial types
+    template <class U> void construct(U* p) { ::new ((void*)p) U; }
+    template <class U, class... A> void construct(U* p, A&&... a) { ::new ((void*)p) U(std::forward<A>(a)...); }
+
+    template <class U> bool operator==(const FirstTouchAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const FirstTouchAllocator<U>&) const { return false; }
+};
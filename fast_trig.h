@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FAST_TRIG_SSE 1
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Fast sin/cos
+//  Range reduction to r in [-pi/4, pi/4] by the nearest multiple of pi/2 (a
+//  three-part Cody-Waite constant, exact up to MAX_ARG), then minimax
+//  polynomials for sin and cos on that interval; the quadrant picks and signs
+//  the result without branches. No special cases for inf/nan.
+//  Max absolute error against double-precision sin/cos is 9.3e-8 for
+//  |x| <= MAX_ARG (libm sinf: 3.3e-8), about one float ulp at 1;
+//  tests/fast_trig_test.cpp checks it against MAX_ABS_ERROR. The scalar and
+//  4-wide versions give identical results unless the compiler contracts the
+//  scalar one into fused multiply-adds (-ffp-contract=fast with FMA).
+// ─────────────────────────────────────────────────────────────────────────────
+namespace fast {
+
+constexpr float MAX_ABS_ERROR = 1.5e-7f;
+// 2^16 * pi/2, the last argument for which the reduction is exact and the
+// error bound holds. The largest phase the animation feeds in is 3 t + d,
+// so this is about 9.5 hours of animation time; by then a float time has
+// steps of 1/256 s anyway.
+constexpr float MAX_ARG = 102943.f;
+
+constexpr float TWO_OVER_PI = 0.636619772367581f;
+constexpr float PIO2_1 = 1.5703125f;                    // pi/2 in three parts,
+constexpr float PIO2_2 = 4.84466552734375e-4f;          // the first two 8 bits
+constexpr float PIO2_3 = -6.397578431460715e-7f;        // wide, so q * PIO2_1 and
+                                                        // q * PIO2_2 are exact
+                                                        // for any q < 2^16
+
+// sin(r) ~ r + r^3 (S1 + S2 r^2 + S3 r^4), cos(r) ~ 1 - r^2/2 + r^4 (C1 + C2 r^2 + C3 r^4)
+constexpr float S1 = -1.6666654611e-1f, S2 = 8.3321608736e-3f, S3 = -1.9515295891e-4f;
+constexpr float C1 = 4.166664568298827e-2f, C2 = -1.388731625493765e-3f, C3 = 2.443315711809948e-5f;
+
+// Nearest integer, ties to even like the 4-wide conversion (lrintf is a
+// library call unless math errno is off)
+inline int roundInt(float x)
+{
+#ifdef FAST_TRIG_SSE
+    return _mm_cvtss_si32(_mm_set_ss(x));
+#else
+    return (int)lrintf(x);
+#endif
+}
+
+inline void sincos(float x, float& s, float& c)
+{
+    int   q = roundInt(x * TWO_OVER_PI);
+    float qf = (float)q;
+    float r = ((x - qf * PIO2_1) - qf * PIO2_2) - qf * PIO2_3;
+    float z = r * r;
+    float ps = r + r * z * (S1 + z * (S2 + z * S3));
+    float pc = 1.f - 0.5f * z + z * z * (C1 + z * (C2 + z * C3));
+    // quadrant q: (sin, cos) = (ps, pc), (pc, -ps), (-ps, -pc), (-pc, ps)
+    float a = q & 1 ? pc : ps, b = q & 1 ? ps : pc;
+    s = q & 2 ? -a : a;
+    c = (q + 1) & 2 ? -b : b;
+}
+
+inline float sin(float x) { float s, c; sincos(x, s, c); return s; }
+inline float cos(float x) { float s, c; sincos(x, s, c); return c; }
+
+// Four arguments at once: s[i], c[i] = sin(x[i]), cos(x[i])
+#ifdef FAST_TRIG_SSE
+inline void sincos4(__m128 x, __m128& s, __m128& c)
+{
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+    __m128  qf = _mm_cvtepi32_ps(q);
+    __m128  r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(PIO2_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(PIO2_2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(PIO2_3)));
+    __m128 z = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(S3)), _mm_set1_ps(S2));
+    ps = _mm_add_ps(_mm_mul_ps(z, ps), _mm_set1_ps(S1));
+    ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), ps));
+    __m128 pc = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(C3)), _mm_set1_ps(C2));
+    pc = _mm_add_ps(_mm_mul_ps(z, pc), _mm_set1_ps(C1));
+    pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), pc));
+
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 a = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+    __m128 b = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+    // bit 1 of q (and of q + 1) moved up to the float sign bit
+    __m128 sSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 cSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+    s = _mm_xor_ps(a, sSign);
+    c = _mm_xor_ps(b, cSign);
+}
+#endif
+
+inline void sincos4(const float x[4], float s[4], float c[4])
+{
+#ifdef FAST_TRIG_SSE
+    __m128 vs, vc;
+    sincos4(_mm_loadu_ps(x), vs, vc);
+    _mm_storeu_ps(s, vs);
+    _mm_storeu_ps(c, vc);
+#else
+    for (int i = 0; i < 4; i++) sincos(x[i], s[i], c[i]);
+#endif
+}
+
+} // namespace fast
@@ -0,0 +1,682 @@
+#pragma once
+
+#include "gl_util.h"
+#include "mesh_file.h"
+#include "renderer.h"
+#include "scene.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Mesh arena
+//  Every mesh lives in one shared vertex buffer (pos + normal) and one index
+//  buffer, so a single VAO and a single multi-draw cover all object kinds.
+// ─────────────────────────────────────────────────────────────────────────────
+struct MeshRange {
+    GLuint firstIndex, count;
+    GLint  baseVertex;
+};
+
+class MeshArena {
+public:
+    // Indexed copy of a pos+normal triangle list, identical vertices merged
+    MeshRange add(const float* verts, int vertexCount)
+    {
+        MeshRange r{ (GLuint)indices.size(), (GLuint)vertexCount, (GLint)(vertices.size() / 6) };
+        size_t first = vertices.size();
+        for (int v = 0; v < vertexCount; v++) {
+            const float* p = verts + v * 6;
+            size_t k = first;
+            while (k < vertices.size() && memcmp(&vertices[k], p, 6 * sizeof(float)) != 0) k += 6;
+            if (k == vertices.size()) vertices.insert(vertices.end(), p, p + 6);
+            indices.push_back((uint32_t)((k - first) / 6));
+        }
+        return r;
+    }
+
+    // VAO over the arena: attribs 0/1 and the index buffer
+    void upload()
+    {
+        vbo = makeBuffer(vertices.size() * sizeof(float), vertices.data(), false);
+        ebo = makeBuffer(indices.size() * sizeof(uint32_t), indices.data(), false);
+        if (hasDsa()) {
+            glCreateVertexArrays(1, &vao);
+            glVertexArrayVertexBuffer(vao, 0, vbo, 0, 6 * sizeof(float));
+            glVertexArrayElementBuffer(vao, ebo);
+            vertexAttrib(vao, 0, 3, 0, 0);
+            vertexAttrib(vao, 1, 3, 3 * sizeof(float), 0);
+            return;
+        }
+        glGenVertexArrays(1, &vao);
+        glState().bindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+    }
+
+    void destroy()
+    {
+        glDeleteVertexArrays(1, &vao);
+        GLuint bufs[2] = { vbo, ebo };
+        glDeleteBuffers(2, bufs);
+        vao = vbo = ebo = 0;
+        glState().invalidate();
+    }
+
+    GLuint vertexArray() const { return vao; }
+
+private:
+    std::vector<float>    vertices;
+    std::vector<uint32_t> indices;
+    GLuint vao = 0, vbo = 0, ebo = 0;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  OpenGL backend
+//  Owns the cube mesh, the per-instance buffers and the uniforms that come
+//  from the SceneDesc. Which programs a submit draws with is chosen per pass
+//  by use(); a zero program skips that kind of command, so passes can draw
+//  only the cubes or only the markers of the same list.
+//  With GL 4.3 and shader draw parameters, the indirect program draws the
+//  whole list with one glMultiDrawElementsIndirect: gl_DrawID picks each
+//  draw's transform and colour from an SSBO, gl_BaseInstance + gl_InstanceID
+//  the cube's grid position and state pair. Older contexts draw run by run.
+//  On GL 4.5 buffers and VAOs are built and edited with direct state access:
+//  the vertex format is fixed at init and a cube run only moves the instance
+//  buffer bindings' offsets. Binds go through the state cache either way.
+// ─────────────────────────────────────────────────────────────────────────────
+class GlBackend : public RenderBackend {
+public:
+    struct Stats {
+        int draws = 0;          // API draw calls
+        int stateChanges = 0;   // binds issued, instance re-points, per-draw uniforms
+        int redundantBinds = 0; // binds the cache dropped
+    };
+
+    // Laid out as the cull shader's Counters block
+    struct MeshletStats {
+        GLuint drawn = 0, outside = 0, backFacing = 0;
+        GLuint tested = 0;      // (instance, meshlet) pairs
+    };
+
+    static bool indirectSupported() { return GLAD_GL_VERSION_4_3 && GLAD_GL_ARB_shader_draw_parameters; }
+
+    void init(const SceneDesc& s, std::vector<GLuint> lit, std::vector<GLuint> markers)
+    {
+        litProgs = std::move(lit);
+        markerProgs = std::move(markers);
+        litProgs.erase(std::remove(litProgs.begin(), litProgs.end(), 0u), litProgs.end());
+        count = s.count;
+
+        meshVBO = makeBuffer(sizeof(CUBE_VERTS), CUBE_VERTS, false);
+        baseVBO = makeBuffer(count * sizeof(glm::vec2), s.base, false);
+        stateVBO = makeBuffer(count * sizeof(InstanceState), nullptr, true);
+        prevStateVBO = makeBuffer(count * sizeof(InstanceState), nullptr, true);
+        if (hasDsa()) initVertexArraysDsa();
+        else initVertexArrays();
+        lightUBO = makeBuffer(SceneDesc::MAX_POINT_LIGHTS * 4 * sizeof(glm::vec4), nullptr, true);
+        glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK, lightUBO);
+
+        // Static uniforms: set once, they live in the program object
+        for (GLuint p : litProgs) {
+            glState().useProgram(p);
+            setStaticLighting(p, s);
+        }
+        startFrame();
+    }
+
+    // Programs that arrive after init: same static uniforms, and the next
+    // updateUniforms sets everything per-frame on every program
+    void addPrograms(const SceneDesc& s, const std::vector<GLuint>& lit, const std::vector<GLuint>& markers)
+    {
+        for (GLuint p : lit) {
+            if (!p) continue;
+            litProgs.push_back(p);
+            glState().useProgram(p);
+            setStaticLighting(p, s);
+        }
+        for (GLuint p : markers) if (p) markerProgs.push_back(p);
+        uniformsStale = true;
+    }
+
+    // Arena, draw SSBO and indirect buffer for the multi-draw program; prog
+    // must also be one of the lit programs so it gets the scene uniforms
+    void initIndirect(GLuint prog)
+    {
+        indirectProg = prog;
+        cubeMesh = arena.add(CUBE_VERTS, 36);
+        markerMesh = cubeMesh;          // same shape, its own draw data
+        arena.upload();
+        drawSSBO = makeStreamBuffer();
+        indirectBuf = makeStreamBuffer();
+    }
+
+    // Sculpture elements drawn with a baked mesh instead of the cube (light
+    // markers stay cubes). The file's vertex and index sections go into one
+    // buffer with a single storage call and are read in their packed format.
+    void setMesh(const MappedMesh& m)
+    {
+        const MeshFileHeader& h = m.header();
+        meshBuf = makeBuffer((GLsizeiptr)m.gpuSize(), m.gpuData(), false);
+        meshIndices = (GLsizei)h.indexCount;
+        meshIndexType = h.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        meshIndexOffset = h.indexOffset - h.vertexOffset;
+        packedMeshFormat(cubeVAO);
+        if (hasDsa()) glCreateVertexArrays(1, &meshVAO);
+        else glGenVertexArrays(1, &meshVAO);
+        packedMeshFormat(meshVAO);
+        if (h.meshletCount) {
+            meshletBuf = makeBuffer(h.meshletCount * sizeof(MeshletRecord), m.meshlets(), false);
+            meshletCount = h.meshletCount;
+            meshletTriangles = h.indexCount / 3;
+        }
+    }
+
+    // Per-instance meshlets cost a draw command each, so they only pay off
+    // for meshes whose meshlets are reasonably full
+    bool meshletsWorthCulling() const { return meshletCount && meshletTriangles >= meshletCount * MIN_MESHLET_TRIANGLES; }
+
+    // The multi-draw then draws a baked mesh meshlet by meshlet: before the
+    // draw, cull (MESHLET_CULL) tests every (visible instance, meshlet) pair
+    // against the frustum and its normal cone and appends a draw command for
+    // each survivor. Needs setMesh with meshlets and initIndirect first.
+    void initMeshletCull(GLuint cull)
+    {
+        cullProg = cull;
+        meshletCapacity = std::min((size_t)count * meshletCount, MAX_MESHLET_DRAWS);
+        meshletCmdBuf = makeBuffer(meshletCapacity * sizeof(IndirectCmd), nullptr, false);
+        counterBuf = makeBuffer(sizeof(MeshletStats), nullptr, true);
+        runBuf = makeStreamBuffer();
+        glState().useProgram(cullProg);
+        setInt(cullProg, "meshletCount", (int)meshletCount);
+        setInt(cullProg, "indexBase", (int)(meshIndexOffset / (meshIndexType == GL_UNSIGNED_SHORT ? 2 : 4)));
+    }
+
+    bool meshletCulling() const { return cullProg != 0; }
+
+    // Last cull's counts; reads back from the GPU, so for reports only
+    MeshletStats meshletStats() const
+    {
+        MeshletStats st;
+        if (!cullProg) return st;
+        if (hasDsa()) glGetNamedBufferSubData(counterBuf, 0, sizeof st, &st);
+        else {
+            glState().bindBuffer(GL_COPY_READ_BUFFER, counterBuf);
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof st, &st);
+        }
+        st.tested = lastPairs;
+        return st;
+    }
+
+    void destroy()
+    {
+        glDeleteVertexArrays(1, &cubeVAO);
+        glDeleteVertexArrays(1, &lightVAO);
+        glDeleteVertexArrays(1, &meshVAO);
+        GLuint bufs[12] = { meshVBO, baseVBO, stateVBO, prevStateVBO, drawSSBO, indirectBuf, lightUBO, meshBuf,
+                            meshletBuf, meshletCmdBuf, counterBuf, runBuf };
+        glDeleteBuffers(12, bufs);
+        if (cullProg) glDeleteProgram(cullProg);
+        arena.destroy();
+        glState().invalidate();
+    }
+
+    // Camera uniforms when the view (or projection jitter) changed; light
+    // positions and animTime when the animation moved
+    void updateUniforms(const SceneDesc& s, const glm::mat4& drawProj, bool viewDirty, bool animDirty)
+    {
+        viewDirty = viewDirty || uniformsStale;
+        animDirty = animDirty || uniformsStale;
+        uniformsStale = false;
+        glm::mat4 viewProj = s.proj * s.view;
+        if (viewDirty)
+            for (GLuint p : litProgs) {
+                glState().useProgram(p);
+                setMat4(p, "projection", drawProj);
+                setMat4(p, "curViewProj", viewProj);
+                setMat4(p, "view", s.view);
+                setVec3(p, "viewPos", s.viewPos);
+                setVec3(p, "spotLight.position", s.spotLight.position);
+                setVec3(p, "spotLight.direction", s.spotLight.direction);
+            }
+        if (animDirty) {
+            uploadLights(s);
+            for (GLuint p : litProgs) {
+                glState().useProgram(p);
+                setFloat(p, "animTime", s.animTime);
+            }
+        }
+        if (viewDirty)
+            for (GLuint p : markerProgs) {
+                glState().useProgram(p);
+                setMat4(p, "projection", drawProj);
+                setMat4(p, "curViewProj", viewProj);
+                setMat4(p, "view", s.view);
+            }
+    }
+
+    // Streams instances [lo, hi) of the packet. Last frame's pairs are kept
+    // for motion vectors: whatever was uploaded last frame or is about to be
+    // overwritten now.
+    void uploadStates(const SceneDesc& s, int lo, int hi)
+    {
+        int copyLo = lo, copyHi = hi;
+        if (prevHi > prevLo) {
+            copyLo = hi > lo ? std::min(lo, prevLo) : prevLo;
+            copyHi = std::max(hi, prevHi);
+        }
+        if (copyHi > copyLo)
+            copyBuffer(stateVBO, prevStateVBO, copyLo * sizeof(InstanceState), (copyHi - copyLo) * sizeof(InstanceState));
+        if (hi > lo)
+            updateBuffer(stateVBO, lo * sizeof(InstanceState), (hi - lo) * sizeof(InstanceState), &s.states[lo]);
+        prevLo = lo; prevHi = hi;
+    }
+
+    // Programs for the following submits; motion also feeds last frame's
+    // transforms to the MOTION_VECTORS variants
+    void use(GLuint lit, GLuint marker, bool motion)
+    {
+        litProg = lit; markerProg = marker; withMotion = motion;
+    }
+
+    void submit(const SceneDesc& s, const CommandList& cmds) override
+    {
+        if (litProg && litProg == indirectProg) {
+            submitIndirect(s, cmds);
+            return;
+        }
+        if (litProg) {
+            glState().useProgram(litProg);
+            glState().bindVertexArray(cubeVAO);
+            if (withMotion) {
+                setMat4(litProg, "prevViewProj", prevViewProj);
+                setFloat(litProg, "prevAnimTime", prevAnimTime);
+                frame.stateChanges += 2;
+            }
+            for (const DrawCmd& c : cmds.commands()) {
+                if (c.kind != DrawCmd::Cubes) continue;
+                pointInstances(c.first);
+                if (meshIndices)
+                    glDrawElementsInstanced(GL_TRIANGLES, meshIndices, meshIndexType, (void*)meshIndexOffset, c.count);
+                else
+                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, c.count);
+                frame.draws++;
+            }
+        }
+        if (markerProg) {
+            glState().useProgram(markerProg);
+            glState().bindVertexArray(lightVAO);
+            for (const DrawCmd& c : cmds.commands()) {
+                if (c.kind != DrawCmd::Marker) continue;
+                setVec3(markerProg, "lightColor", s.markerColour[c.first]);
+                setMat4(markerProg, "model", markerModel(s.pointLights[c.first].position, s.markerSize));
+                frame.stateChanges += 2;
+                if (withMotion) {
+                    glm::vec3 prev = (size_t)c.first < prevMarker.size() ? prevMarker[c.first] : s.pointLights[c.first].position;
+                    setMat4(markerProg, "prevMVP", prevViewProj * markerModel(prev, s.markerSize));
+                    frame.stateChanges++;
+                }
+                glDrawArrays(GL_TRIANGLES, 0, 36);
+                frame.draws++;
+            }
+        }
+    }
+
+    // Remember this frame for next frame's motion vectors
+    void endFrame(const SceneDesc& s)
+    {
+        prevViewProj = s.proj * s.view;
+        prevAnimTime = s.animTime;
+        prevMarker.resize(s.pointLights.size());
+        for (size_t i = 0; i < s.pointLights.size(); i++) prevMarker[i] = s.pointLights[i].position;
+        Stats f = frameStats();
+        total.draws += f.draws;
+        total.stateChanges += f.stateChanges;
+        total.redundantBinds += f.redundantBinds;
+        startFrame();
+    }
+
+    bool indirect() const { return indirectProg != 0; }
+    // So far this frame; binds are counted by the state cache, whoever made them
+    Stats frameStats() const
+    {
+        Stats f = frame;
+        f.stateChanges += glState().issued() - issuedMark;
+        f.redundantBinds = glState().skipped() - skippedMark;
+        return f;
+    }
+
+    const Stats& totals() const { return total; }       // since resetStats()
+    bool dsa() const { return hasDsa(); }
+    void resetStats() { total = {}; }
+
+private:
+    // One multi-draw for the whole list: cube runs are instanced draws whose
+    // base instance is the run's first cube; markers are single instances
+    // flagged unlit by their colour's alpha
+    struct DrawData {
+        glm::mat4 model;
+        glm::vec4 colour;
+    };
+
+    struct IndirectCmd {
+        GLuint count, instanceCount, firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    // A baked mesh has its own buffer and vertex format, so its cubes go
+    // first in a multi-draw of their own and the markers follow in a second;
+    // drawBase tells the shader where the second one's DrawData starts.
+    // With meshlet culling the cubes' multi-draw is the cull's output, whose
+    // draws all share the first DrawData (oneDraw).
+    void submitIndirect(const SceneDesc& s, const CommandList& cmds)
+    {
+        indirectCmds.clear();
+        drawData.clear();
+        runData.clear();
+        bool split = meshIndices > 0;
+        GLuint meshFirst = (GLuint)(meshIndexOffset / (meshIndexType == GL_UNSIGNED_SHORT ? 2 : 4));
+        size_t instances = 0;
+        for (const DrawCmd& c : cmds.commands()) if (c.kind == DrawCmd::Cubes) instances += c.count;
+        bool clusters = split && cullProg && instances * meshletCount <= meshletCapacity;
+        int cubeDraws = 0, cubeData = 0;
+        GLuint slots = 0;
+        for (int pass = 0; pass < (split ? 2 : 1); pass++)
+            for (const DrawCmd& c : cmds.commands()) {
+                bool cube = c.kind == DrawCmd::Cubes;
+                if (split && cube != (pass == 0)) continue;
+                if (cube) {
+                    if (clusters) {
+                        runData.push_back({ (GLuint)c.first, (GLuint)c.count, slots, 0 });
+                        slots += c.count;
+                        if (cubeData) continue;
+                    }
+                    else {
+                        if (split) indirectCmds.push_back({ (GLuint)meshIndices, (GLuint)c.count, meshFirst, 0, (GLuint)c.first });
+                        else indirectCmds.push_back({ cubeMesh.count, (GLuint)c.count, cubeMesh.firstIndex, cubeMesh.baseVertex, (GLuint)c.first });
+                        cubeDraws++;
+                    }
+                    drawData.push_back({ glm::mat4(1.f), glm::vec4(0.f) });
+                    cubeData++;
+                }
+                else if (markerProg) {
+                    indirectCmds.push_back({ markerMesh.count, 1, markerMesh.firstIndex, markerMesh.baseVertex, 0 });
+                    drawData.push_back({ markerModel(s.pointLights[c.first].position, s.markerSize),
+                                         glm::vec4(s.markerColour[c.first], 1.f) });
+                }
+            }
+        if (indirectCmds.empty() && runData.empty()) return;
+
+        streamBuffer(drawSSBO, GL_SHADER_STORAGE_BUFFER, drawData.size() * sizeof(DrawData), drawData.data());
+        streamBuffer(indirectBuf, GL_DRAW_INDIRECT_BUFFER, indirectCmds.size() * sizeof(IndirectCmd), indirectCmds.data());
+        glState().useProgram(indirectProg);
+        glState().bindStorage(0, drawSSBO);
+        glState().bindStorage(1, baseVBO);
+        glState().bindStorage(2, stateVBO);
+        glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuf);
+        if (!split) {
+            glState().bindVertexArray(arena.vertexArray());
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)indirectCmds.size(), 0);
+            frame.draws++;
+            return;
+        }
+        int markerDraws = (int)indirectCmds.size() - cubeDraws;
+        if (!runData.empty()) {
+            GLsizei pairs = (GLsizei)(instances * meshletCount);
+            cullMeshlets(s, pairs);
+            glState().useProgram(indirectProg);
+            glState().bindVertexArray(meshVAO);
+            glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, meshletCmdBuf);
+            setInt(indirectProg, "drawBase", 0);
+            setInt(indirectProg, "oneDraw", 1);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, meshIndexType, nullptr, pairs, 0);
+            setInt(indirectProg, "oneDraw", 0);
+            glState().bindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuf);
+            frame.draws++;
+            frame.stateChanges += 3;
+        }
+        if (cubeDraws) {
+            glState().bindVertexArray(meshVAO);
+            setInt(indirectProg, "drawBase", 0);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, meshIndexType, nullptr, cubeDraws, 0);
+            frame.draws++;
+            frame.stateChanges++;
+        }
+        if (markerDraws) {
+            glState().bindVertexArray(arena.vertexArray());
+            setInt(indirectProg, "drawBase", cubeData);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(cubeDraws * sizeof(IndirectCmd)), markerDraws, 0);
+            frame.draws++;
+            frame.stateChanges++;
+        }
+    }
+
+    // Two dispatches over the pairs: the first appends a command per
+    // surviving meshlet, the second turns the rest of the pairs' commands
+    // into empty draws. The multi-draw still walks all of them (its count
+    // is not known on the CPU without GL 4.6 indirect counts), but the
+    // drawn ones are packed at the front.
+    void cullMeshlets(const SceneDesc& s, GLsizei pairs)
+    {
+        static const MeshletStats zero;
+        updateBuffer(counterBuf, 0, sizeof zero, &zero);
+        streamBuffer(runBuf, GL_SHADER_STORAGE_BUFFER, runData.size() * sizeof(glm::uvec4), runData.data());
+        // From the unjittered projection: TAA's sub-pixel jitter moves the
+        // frustum by far less than any meshlet's bounding sphere
+        glm::vec4 planes[6];
+        frustumPlanes(s.proj * s.view, planes);
+
+        glState().useProgram(cullProg);
+        setVec4Array(cullProg, "planes", planes, 6);
+        setVec3(cullProg, "viewPos", s.viewPos);
+        setFloat(cullProg, "animTime", s.animTime);
+        setInt(cullProg, "pairs", pairs);
+        setInt(cullProg, "runCount", (int)runData.size());
+        glState().bindStorage(1, baseVBO);
+        glState().bindStorage(2, stateVBO);
+        glState().bindStorage(3, meshletBuf);
+        glState().bindStorage(4, runBuf);
+        glState().bindStorage(5, meshletCmdBuf);
+        glState().bindStorage(6, counterBuf);
+        GLuint groups = (GLuint)(pairs + 63) / 64;
+        setInt(cullProg, "clearTail", 0);
+        glDispatchCompute(groups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        setInt(cullProg, "clearTail", 1);
+        glDispatchCompute(groups, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+        frame.stateChanges += 8;
+        lastPairs = (GLuint)pairs;
+    }
+
+    // Attribs 0/1 from the baked mesh buffer: half-float position, packed
+    // snorm normal; its index section is the element buffer
+    void packedMeshFormat(GLuint vao)
+    {
+        const GLsizei stride = MappedMesh::STRIDE;
+        if (hasDsa()) {
+            glVertexArrayVertexBuffer(vao, 0, meshBuf, 0, stride);
+            glEnableVertexArrayAttrib(vao, 0);
+            glVertexArrayAttribFormat(vao, 0, 3, GL_HALF_FLOAT, GL_FALSE, 0);
+            glVertexArrayAttribBinding(vao, 0, 0);
+            glEnableVertexArrayAttrib(vao, 1);
+            glVertexArrayAttribFormat(vao, 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, 8);
+            glVertexArrayAttribBinding(vao, 1, 0);
+            glVertexArrayElementBuffer(vao, meshBuf);
+            return;
+        }
+        glState().bindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshBuf);
+        glState().bindBuffer(GL_ARRAY_BUFFER, meshBuf);
+        glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)8);
+        glEnableVertexAttribArray(1);
+    }
+
+    // Sculpture cubes: mesh plus per-instance grid position (static), LOD
+    // state pair (streamed) and last frame's pair for motion vectors.
+    // Buffer bindings: 0 mesh, 1 grid position, 2 state, 3 previous state.
+    void initVertexArraysDsa()
+    {
+        glCreateVertexArrays(1, &cubeVAO);
+        glVertexArrayVertexBuffer(cubeVAO, 0, meshVBO, 0, 6 * sizeof(float));
+        vertexAttrib(cubeVAO, 0, 3, 0, 0);
+        vertexAttrib(cubeVAO, 1, 3, 3 * sizeof(float), 0);
+        vertexAttrib(cubeVAO, 2, 2, 0, 1);
+        for (GLuint k = 0; k < 2; k++) {
+            vertexAttrib(cubeVAO, 3 + k * 2, 4, 0, 2 + k);
+            vertexAttrib(cubeVAO, 4 + k * 2, 4, sizeof(glm::vec4), 2 + k);
+        }
+        for (GLuint b = 1; b <= 3; b++) glVertexArrayBindingDivisor(cubeVAO, b, 1);
+        pointInstances(0);
+
+        // Light markers
+        glCreateVertexArrays(1, &lightVAO);
+        glVertexArrayVertexBuffer(lightVAO, 0, meshVBO, 0, 6 * sizeof(float));
+        vertexAttrib(lightVAO, 0, 3, 0, 0);
+    }
+
+    void initVertexArrays()
+    {
+        glGenVertexArrays(1, &cubeVAO);
+        glState().bindVertexArray(cubeVAO);
+        glState().bindBuffer(GL_ARRAY_BUFFER, meshVBO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        for (GLuint a = 2; a <= 6; a++) {
+            glEnableVertexAttribArray(a);
+            glVertexAttribDivisor(a, 1);
+        }
+        pointInstances(0);
+
+        glGenVertexArrays(1, &lightVAO);
+        glState().bindVertexArray(lightVAO);
+        glState().bindBuffer(GL_ARRAY_BUFFER, meshVBO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+    }
+
+    // GL 3.3 has no base instance: start the instance buffers at the run's
+    // first instance instead. DSA moves the binding offsets; otherwise the
+    // attribute pointers are re-specified with the cube VAO bound.
+    void pointInstances(int first)
+    {
+        if (first == pointedAt) return;
+        const GLuint src[2] = { stateVBO, prevStateVBO };
+        size_t off = first * sizeof(InstanceState);
+        if (hasDsa()) {
+            glVertexArrayVertexBuffer(cubeVAO, 1, baseVBO, first * sizeof(glm::vec2), sizeof(glm::vec2));
+            for (int k = 0; k < 2; k++)
+                glVertexArrayVertexBuffer(cubeVAO, 2 + k, src[k], off, sizeof(InstanceState));
+            frame.stateChanges += 3;
+        }
+        else {
+            glState().bindVertexArray(cubeVAO);
+            glState().bindBuffer(GL_ARRAY_BUFFER, baseVBO);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)(first * sizeof(glm::vec2)));
+            for (int k = 0; k < 2; k++) {
+                glState().bindBuffer(GL_ARRAY_BUFFER, src[k]);
+                glVertexAttribPointer(3 + k * 2, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceState), (void*)off);
+                glVertexAttribPointer(4 + k * 2, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceState), (void*)(off + sizeof(glm::vec4)));
+            }
+            frame.stateChanges += 5;
+        }
+        pointedAt = first;
+    }
+
+    static void setStaticLighting(GLuint p, const SceneDesc& s)
+    {
+        setVec3(p, "matDiffuse", s.mat.diffuse);
+        setVec3(p, "matSpecular", s.mat.specular);
+        setFloat(p, "matShininess", s.mat.shininess);
+
+        setVec3(p, "dirLight.direction", s.dirLight.direction);
+        setVec3(p, "dirLight.ambient", s.dirLight.ambient);
+        setVec3(p, "dirLight.diffuse", s.dirLight.diffuse);
+        setVec3(p, "dirLight.specular", s.dirLight.specular);
+
+        GLuint block = glGetUniformBlockIndex(p, "PointLightBlock");
+        if (block != GL_INVALID_INDEX) glUniformBlockBinding(p, block, LIGHT_BLOCK);
+        setInt(p, "pointLightCount", (int)s.pointLights.size());
+
+        const SpotLight& S = s.spotLight;
+        setFloat(p, "spotLight.cutOff", S.cutOff);
+        setFloat(p, "spotLight.outerCutOff", S.outerCutOff);
+        setFloat(p, "spotLight.constant", S.constant);
+        setFloat(p, "spotLight.linear", S.linear);
+        setFloat(p, "spotLight.quadratic", S.quadratic);
+        setVec3(p, "spotLight.ambient", S.ambient);
+        setVec3(p, "spotLight.diffuse", S.diffuse);
+        setVec3(p, "spotLight.specular", S.specular);
+    }
+
+    // Same packing as the shader's PointLightBlock
+    void uploadLights(const SceneDesc& s)
+    {
+        lightData.clear();
+        for (const PointLight& L : s.pointLights) {
+            lightData.push_back(glm::vec4(L.position, L.constant));
+            lightData.push_back(glm::vec4(L.ambient, L.linear));
+            lightData.push_back(glm::vec4(L.diffuse, L.quadratic));
+            lightData.push_back(glm::vec4(L.specular, 0.f));
+        }
+        updateBuffer(lightUBO, 0, lightData.size() * sizeof(glm::vec4), lightData.data());
+    }
+
+    static const GLuint LIGHT_BLOCK = 0;    // uniform buffer binding
+
+    std::vector<GLuint> litProgs, markerProgs;
+    bool uniformsStale = false;         // programs added since the last updateUniforms
+    GLuint meshVBO = 0, cubeVAO = 0, lightVAO = 0;
+    GLuint baseVBO = 0, stateVBO = 0, prevStateVBO = 0, lightUBO = 0;
+    std::vector<glm::vec4> lightData;
+    int    count = 0, pointedAt = -1;
+    int    prevLo = 0, prevHi = 0;      // state range uploaded last frame
+
+    GLuint litProg = 0, markerProg = 0;
+    bool   withMotion = false;
+    glm::mat4 prevViewProj{ 1.f };
+    float     prevAnimTime = 0;
+    std::vector<glm::vec3> prevMarker;
+
+    GLuint    meshBuf = 0, meshVAO = 0;     // baked mesh, see setMesh
+    GLsizei   meshIndices = 0;
+    GLenum    meshIndexType = GL_UNSIGNED_SHORT;
+    size_t    meshIndexOffset = 0;          // bytes into meshBuf
+
+    static constexpr size_t MAX_MESHLET_DRAWS = 1 << 20;    // beyond this the frame draws whole meshes
+    static constexpr GLuint MIN_MESHLET_TRIANGLES = 32;     // average per meshlet
+    GLuint    meshletBuf = 0, meshletCount = 0, meshletTriangles = 0;
+    GLuint    cullProg = 0, meshletCmdBuf = 0, counterBuf = 0, runBuf = 0;
+    size_t    meshletCapacity = 0;          // commands in meshletCmdBuf
+    GLuint    lastPairs = 0;
+    std::vector<glm::uvec4> runData;        // visible runs: first instance, count, first slot
+
+    GLuint    indirectProg = 0, drawSSBO = 0, indirectBuf = 0;
+    MeshArena arena;
+    MeshRange cubeMesh{}, markerMesh{};
+    std::vector<IndirectCmd> indirectCmds;
+    std::vector<DrawData>    drawData;
+
+    void startFrame()
+    {
+        frame = {};
+        issuedMark = glState().issued();
+        skippedMark = glState().skipped();
+    }
+
+    Stats  frame, total;                // frame: draws and non-bind edits only
+    int    issuedMark = 0, skippedMark = 0;
+};
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Shader helper
+// ─────────────────────────────────────────────────────────────────────────────
+// Defines go straight after the #version line
+inline std::string withDefines(const char* src, const std::string& defines)
+{
+    std::string s = src;
+    if (!defines.empty()) {
+        size_t v = s.find("#version");
+        size_t eol = v == std::string::npos ? 0 : s.find('\n', v) + 1;
+        s.insert(eol, defines);
+    }
+    return s;
+}
+
+inline GLuint compileShader(GLenum type, const char* src, const std::string& defines = "")
+{
+    std::string s = withDefines(src, defines);
+    const char* p = s.c_str();
+
+    GLuint id = glCreateShader(type);
+    glShaderSource(id, 1, &p, nullptr);
+    glCompileShader(id);
+    GLint ok; glGetShaderiv(id, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024]; glGetShaderInfoLog(id, 1024, nullptr, log);
+        std::cerr << "[SHADER ERROR] " << log << "\n";
+    }
+    return id;
+}
+
+// Links the shaders into a program and deletes them
+inline GLuint linkProgram(std::initializer_list<GLuint> shaders)
+{
+    GLuint prog = glCreateProgram();
+    for (GLuint s : shaders) glAttachShader(prog, s);
+    glLinkProgram(prog);
+    GLint ok; glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024]; glGetProgramInfoLog(prog, 1024, nullptr, log);
+        std::cerr << "[LINK ERROR] " << log << "\n";
+    }
+    for (GLuint s : shaders) glDeleteShader(s);
+    return prog;
+}
+
+inline GLuint makeProgram(const char* vsrc, const char* fsrc, const std::string& defines = "")
+{
+    return linkProgram({ compileShader(GL_VERTEX_SHADER, vsrc, defines), compileShader(GL_FRAGMENT_SHADER, fsrc, defines) });
+}
+
+// GL 4.3
+inline GLuint makeComputeProgram(const char* src, const std::string& defines = "")
+{
+    return linkProgram({ compileShader(GL_COMPUTE_SHADER, src, defines) });
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Bind cache
+//  Program, VAO and buffer binds go through here so a bind of what is already
+//  bound never reaches the driver. Each call returns whether it was issued.
+//  Code that binds behind its back, or deletes bound objects, invalidates.
+// ─────────────────────────────────────────────────────────────────────────────
+class GlStateCache {
+public:
+    bool useProgram(GLuint p)
+    {
+        if (p == program) return skip();
+        glUseProgram(p);
+        program = p;
+        return issue();
+    }
+
+    bool bindVertexArray(GLuint v)
+    {
+        if (v == vao) return skip();
+        glBindVertexArray(v);
+        vao = v;
+        return issue();
+    }
+
+    bool bindBuffer(GLenum target, GLuint b)
+    {
+        GLuint* cur = slot(target);
+        if (cur && *cur == b) return skip();
+        glBindBuffer(target, b);
+        if (cur) *cur = b;
+        return issue();
+    }
+
+    // Indexed SSBO binding; also sets the generic GL_SHADER_STORAGE_BUFFER one
+    bool bindStorage(GLuint index, GLuint b)
+    {
+        if (index < STORAGE_SLOTS && storage[index] == b) return skip();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, b);
+        if (index < STORAGE_SLOTS) storage[index] = b;
+        *slot(GL_SHADER_STORAGE_BUFFER) = b;
+        return issue();
+    }
+
+    void invalidate()
+    {
+        program = vao = ~0u;
+        for (GLuint& b : buffers) b = ~0u;
+        for (GLuint& b : storage) b = ~0u;
+    }
+
+    int  issued() const { return binds; }
+    int  skipped() const { return redundant; }
+
+private:
+    static const unsigned STORAGE_SLOTS = 8;
+
+    // Element array bindings are VAO state and other targets are unused:
+    // those are not tracked and always rebind
+    GLuint* slot(GLenum target)
+    {
+        switch (target) {
+        case GL_ARRAY_BUFFER:          return &buffers[0];
+        case GL_COPY_READ_BUFFER:      return &buffers[1];
+        case GL_COPY_WRITE_BUFFER:     return &buffers[2];
+        case GL_DRAW_INDIRECT_BUFFER:  return &buffers[3];
+        case GL_SHADER_STORAGE_BUFFER: return &buffers[4];
+        default:                       return nullptr;
+        }
+    }
+
+    bool issue() { binds++; return true; }
+    bool skip() { redundant++; return false; }
+
+    GLuint program = ~0u, vao = ~0u;
+    GLuint buffers[5] = { ~0u, ~0u, ~0u, ~0u, ~0u };
+    GLuint storage[STORAGE_SLOTS] = { ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u, ~0u };
+    int    binds = 0, redundant = 0;
+};
+
+inline GlStateCache& glState()
+{
+    static GlStateCache cache;
+    return cache;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Buffers
+//  GL 4.5 direct state access where available, so creating and updating a
+//  buffer leaves the bindings alone; bind-to-edit through the cache otherwise.
+// ─────────────────────────────────────────────────────────────────────────────
+inline bool hasDsa() { return GLAD_GL_VERSION_4_5; }
+
+// Fixed-size storage; dynamic ones take updateBuffer/copyBuffer
+inline GLuint makeBuffer(GLsizeiptr size, const void* data, bool dynamic)
+{
+    GLuint b;
+    if (hasDsa()) {
+        glCreateBuffers(1, &b);
+        glNamedBufferStorage(b, size, data, dynamic ? GL_DYNAMIC_STORAGE_BIT : 0);
+    }
+    else {
+        glGenBuffers(1, &b);
+        glState().bindBuffer(GL_ARRAY_BUFFER, b);
+        glBufferData(GL_ARRAY_BUFFER, size, data, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    }
+    return b;
+}
+
+// Resized and refilled every frame: no storage until the first streamBuffer
+inline GLuint makeStreamBuffer()
+{
+    GLuint b;
+    if (hasDsa()) glCreateBuffers(1, &b);
+    else glGenBuffers(1, &b);
+    return b;
+}
+
+inline void streamBuffer(GLuint b, GLenum target, GLsizeiptr size, const void* data)
+{
+    if (hasDsa()) glNamedBufferData(b, size, data, GL_STREAM_DRAW);
+    else {
+        glState().bindBuffer(target, b);
+        glBufferData(target, size, data, GL_STREAM_DRAW);
+    }
+}
+
+inline void updateBuffer(GLuint b, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    if (hasDsa()) glNamedBufferSubData(b, offset, size, data);
+    else {
+        glState().bindBuffer(GL_ARRAY_BUFFER, b);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+}
+
+// Same range from one buffer to the other
+inline void copyBuffer(GLuint src, GLuint dst, GLintptr offset, GLsizeiptr size)
+{
+    if (hasDsa()) glCopyNamedBufferSubData(src, dst, offset, offset, size);
+    else {
+        glState().bindBuffer(GL_COPY_READ_BUFFER, src);
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, dst);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, offset, size);
+    }
+}
+
+// DSA vertex format: float attribute read from one of the VAO's buffer bindings
+inline void vertexAttrib(GLuint vao, GLuint attr, GLint size, GLuint offset, GLuint binding)
+{
+    glEnableVertexArrayAttrib(vao, attr);
+    glVertexArrayAttribFormat(vao, attr, size, GL_FLOAT, GL_FALSE, offset);
+    glVertexArrayAttribBinding(vao, attr, binding);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Uniform setters
+// ─────────────────────────────────────────────────────────────────────────────
+inline void setInt(GLuint p, const char* n, int v) { glUniform1i(glGetUniformLocation(p, n), v); }
+inline void setFloat(GLuint p, const char* n, float v) { glUniform1f(glGetUniformLocation(p, n), v); }
+inline void setVec2(GLuint p, const char* n, glm::vec2 v) { glUniform2fv(glGetUniformLocation(p, n), 1, glm::value_ptr(v)); }
+inline void setVec3(GLuint p, const char* n, glm::vec3 v) { glUniform3fv(glGetUniformLocation(p, n), 1, glm::value_ptr(v)); }
+inline void setVec4Array(GLuint p, const char* n, const glm::vec4* v, int count) { glUniform4fv(glGetUniformLocation(p, n), count, glm::value_ptr(v[0])); }
+inline void setMat4(GLuint p, const char* n, const glm::mat4& m) { glUniformMatrix4fv(glGetUniformLocation(p, n), 1, GL_FALSE, glm::value_ptr(m)); }
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Render targets
+// ─────────────────────────────────────────────────────────────────────────────
+inline GLuint makeTexture(int w, int h, GLenum internalFmt, GLenum fmt, GLenum type, GLenum filter = GL_LINEAR)
+{
+    GLuint t;
+    glGenTextures(1, &t);
+    glBindTexture(GL_TEXTURE_2D, t);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFmt, w, h, 0, fmt, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return t;
+}
+
+// FBO over the given colour textures and depth texture (0 = none)
+inline GLuint makeFramebuffer(const std::vector<GLuint>& colour, GLuint depth)
+{
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    std::vector<GLenum> bufs;
+    for (size_t i = 0; i < colour.size(); i++) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GLenum(GL_COLOR_ATTACHMENT0 + i), GL_TEXTURE_2D, colour[i], 0);
+        bufs.push_back(GLenum(GL_COLOR_ATTACHMENT0 + i));
+    }
+    if (depth) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+    glDrawBuffers((GLsizei)bufs.size(), bufs.data());
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "[FBO ERROR] incomplete framebuffer\n";
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return fbo;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Fullscreen passes
+//  One oversized triangle generated from gl_VertexID; uv covers [0,1]^2.
+// ─────────────────────────────────────────────────────────────────────────────
+static const char* FULLSCREEN_VERT = R"GLSL(
+#version 330 core
+out vec2 uv;
+void main()
+{
+    uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)GLSL";
+
+static const char* COPY_FRAG = R"GLSL(
+#version 330 core
+in vec2 uv;
+out vec4 FragColor;
+uniform sampler2D src;
+void main()
+{
+    FragColor = vec4(texture(src, uv).rgb, 1.0);
+}
+)GLSL";
+
+inline void drawFullscreen(GLuint emptyVAO)
+{
+    glState().bindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  GPU timer
+//  GL_TIME_ELAPSED queries in a small ring so reading never stalls; ms() is
+//  the most recent finished measurement, a few frames behind.
+// ─────────────────────────────────────────────────────────────────────────────
+class GpuTimer {
+public:
+    void init() { glGenQueries(RING, q); }
+    void begin() { glBeginQuery(GL_TIME_ELAPSED, q[frame % RING]); }
+    void end()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        frame++;
+        if (frame < RING) return;
+        GLuint oldest = q[frame % RING];
+        GLint ready = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (!ready) return;
+        GLuint64 ns; glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &ns);
+        last = ns * 1e-6;
+        total += last; samples++;
+    }
+    double ms() const { return last; }
+    double meanMs() const { return samples ? total / samples : 0; }
+    void   reset() { total = 0; samples = 0; }
+
+private:
+    static const int RING = 4;
+    GLuint q[RING] = {};
+    unsigned frame = 0;
+    double last = 0, total = 0;
+    int samples = 0;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Image comparison
+// ─────────────────────────────────────────────────────────────────────────────
+inline std::vector<float> readColour(GLuint fbo, int w, int h)
+{
+    std::vector<float> px(w * h * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(fbo ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+    glReadPixels(0, 0, w, h, GL_RGB, GL_FLOAT, px.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    return px;
+}
+
+// PSNR of b against reference a, colours clamped to [0,1]
+inline double psnr(const std::vector<float>& a, const std::vector<float>& b)
+{
+    double se = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double d = glm::clamp(a[i], 0.f, 1.f) - glm::clamp(b[i], 0.f, 1.f);
+        se += d * d;
+    }
+    double mse = se / a.size();
+    return mse > 0 ? 10.0 * std::log10(1.0 / mse) : 99.0;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Input recording
+//  A session log holds every frame's dt and held keys, plus the cursor and
+//  scroll events delivered before it, each stamped with seconds since the
+//  start. Replaying feeds the same events and dt back, so the sculpture goes
+//  through the same frames; real-time replay also paces frames to the stamps.
+//  File: "KSIN", u32 version, u32 grid size, then records of a u8 tag and
+//  floats (a frame adds a u16 key mask), all little-endian whatever the host.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace session_io {
+
+inline void putLe(FILE* f, uint32_t v, int bytes)
+{
+    for (int i = 0; i < bytes; i++) fputc((v >> (8 * i)) & 0xFF, f);
+}
+
+inline void putFloat(FILE* f, float x)
+{
+    uint32_t v;
+    memcpy(&v, &x, sizeof v);
+    putLe(f, v, 4);
+}
+
+inline uint32_t getLe(const uint8_t* p, int bytes)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+inline float getFloat(const uint8_t* p)
+{
+    uint32_t v = getLe(p, 4);
+    float x;
+    memcpy(&x, &v, sizeof x);
+    return x;
+}
+
+} // namespace session_io
+
+struct InputEvent {
+    enum Tag : uint8_t { Frame = 1, Cursor = 2, Scroll = 3 };
+    Tag      tag;
+    float    t;
+    float    a, b;      // frame: dt; cursor: x, y; scroll: y offset
+    uint16_t keys;      // frame: held keys, one bit per replayed key
+};
+
+class InputRecorder {
+public:
+    static const uint32_t VERSION = 1;
+
+    ~InputRecorder() { close(); }
+
+    bool open(const std::string& path, int grid)
+    {
+        f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        fwrite("KSIN", 1, 4, f);
+        session_io::putLe(f, VERSION, 4);
+        session_io::putLe(f, (uint32_t)grid, 4);
+        start = clk::now();
+        return true;
+    }
+
+    void close()
+    {
+        if (f) fclose(f);
+        f = nullptr;
+    }
+
+    bool  active() const { return f != nullptr; }
+    float now() const { return std::chrono::duration<float>(clk::now() - start).count(); }
+    int   frames() const { return frameCount; }
+
+    void frame(float dt, uint16_t keys)
+    {
+        if (!f) return;
+        put(InputEvent::Frame, now(), dt, 0.f);
+        session_io::putLe(f, keys, 2);
+        frameCount++;
+    }
+
+    void cursor(float x, float y) { put(InputEvent::Cursor, now(), x, y); }
+    void scroll(float dy) { put(InputEvent::Scroll, now(), dy, 0.f); }
+
+private:
+    using clk = std::chrono::steady_clock;
+
+    void put(InputEvent::Tag tag, float t, float a, float b)
+    {
+        if (!f) return;
+        fputc(tag, f);
+        session_io::putFloat(f, t);
+        session_io::putFloat(f, a);
+        if (tag == InputEvent::Cursor) session_io::putFloat(f, b);
+    }
+
+    FILE* f = nullptr;
+    clk::time_point start;
+    int   frameCount = 0;
+};
+
+class InputReplay {
+public:
+    bool open(const std::string& path, int grid)
+    {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        std::vector<uint8_t> data;
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+        fclose(f);
+
+        if (data.size() < 12 || memcmp(data.data(), "KSIN", 4) != 0) return false;
+        if (session_io::getLe(&data[4], 4) != InputRecorder::VERSION) return false;
+        recordedGrid = (int)session_io::getLe(&data[8], 4);
+        if (recordedGrid != grid)
+            fprintf(stderr, "Replay was recorded at grid %d, running %d\n", recordedGrid, grid);
+
+        for (size_t p = 12; p < data.size();) {
+            InputEvent e{};
+            e.tag = (InputEvent::Tag)data[p++];
+            int floats = e.tag == InputEvent::Cursor ? 3 : 2;
+            size_t need = floats * sizeof(float) + (e.tag == InputEvent::Frame ? sizeof(uint16_t) : 0);
+            if (e.tag < InputEvent::Frame || e.tag > InputEvent::Scroll || p + need > data.size()) break;
+            float v[3] = {};
+            for (int k = 0; k < floats; k++, p += 4) v[k] = session_io::getFloat(&data[p]);
+            e.t = v[0]; e.a = v[1]; e.b = v[2];
+            if (e.tag == InputEvent::Frame) {
+                e.keys = (uint16_t)session_io::getLe(&data[p], 2);
+                p += 2;
+                frameCount++;
+            }
+            events.push_back(e);
+        }
+        loaded = true;
+        return true;
+    }
+
+    bool active() const { return loaded; }
+    int  frames() const { return frameCount; }
+
+    // Next frame: its input events in out, its dt and held keys. In real-time
+    // mode, sleeps until the frame's recorded time. False once the log ends.
+    bool next(std::vector<InputEvent>& out, float& dt, uint16_t& keys, bool realTime)
+    {
+        out.clear();
+        while (cursor < events.size() && events[cursor].tag != InputEvent::Frame)
+            out.push_back(events[cursor++]);
+        if (cursor == events.size()) return false;
+        const InputEvent& f = events[cursor++];
+        dt = f.a;
+        keys = f.keys;
+        if (played++ == 0) { start = clk::now(); t0 = f.t; }
+        else if (realTime)
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<clk::duration>(std::chrono::duration<float>(f.t - t0)));
+        return true;
+    }
+
+private:
+    using clk = std::chrono::steady_clock;
+
+    std::vector<InputEvent> events;
+    size_t cursor = 0;
+    int    frameCount = 0, recordedGrid = 0, played = 0;
+    bool   loaded = false;
+    float  t0 = 0;
+    clk::time_point start;
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MESH_FILE_MMAP 1
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Baked meshes
+//  tools/mesh_convert.py bakes OBJ/glTF (or a built-in shape) into a .ksm
+//  file that loads without parsing: the file is mapped and its vertex and
+//  index sections go to the GPU as they are, in one buffer.
+//  Little-endian; sections start on 64-byte boundaries:
+//    header    MeshFileHeader, 64 bytes
+//    vertices  12 bytes each: position as 3 half floats + 2 bytes padding,
+//              normal as GL_INT_2_10_10_10_REV snorm (x, y, z, w = 0)
+//    indices   u16 when there are at most 65536 vertices, else u32; a
+//              counter-clockwise triangle list in vertex-cache order
+//    meshlets  optional, MeshletRecord each: consecutive runs of the index
+//              list with at most 64 vertices and 124 triangles, for
+//              per-cluster culling
+//  Vertex attributes read straight from that layout as vec3s, so the
+//  shaders do not know the difference.
+// ─────────────────────────────────────────────────────────────────────────────
+struct MeshFileHeader {
+    char     magic[4];              // "KSMS"
+    uint32_t version;
+    uint32_t vertexCount, indexCount;
+    uint32_t vertexStride, indexSize;
+    uint32_t vertexOffset, indexOffset;     // bytes from the start of the file
+    float    boundsMin[3], boundsMax[3];
+    uint32_t meshletCount, meshletOffset;   // zero when the file has none
+};
+static_assert(sizeof(MeshFileHeader) == 64, "the converter writes a 64-byte header");
+
+// Laid out as the cull shader's std430 Meshlet. The cone holds every face
+// normal in the run: from wherever dot(centre - eye, axis) is at least
+// cutoff * |centre - eye| + radius, all of them face away. cutoff 1 (or
+// more) never culls.
+struct MeshletRecord {
+    float    centre[3], radius;
+    float    axis[3], cutoff;
+    uint32_t firstIndex, indexCount;    // into the index section
+    uint32_t pad[2];
+};
+static_assert(sizeof(MeshletRecord) == 48, "std430 vec4, vec4, uvec4");
+
+class MappedMesh {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t STRIDE = 12;
+    static const uint32_t MESHLET_VERTICES = 64, MESHLET_TRIANGLES = 124;
+
+    MappedMesh() = default;
+    ~MappedMesh() { close(); }
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh& operator=(const MappedMesh&) = delete;
+
+    // Maps path and checks the header against the file; err says why not
+    bool open(const std::string& path, std::string& err)
+    {
+        close();
+#ifdef MESH_FILE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { err = "cannot open " + path; return false; }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = (size_t)st.st_size;
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) base = (const uint8_t*)p;
+        }
+        ::close(fd);
+        if (!base) { size = 0; err = "cannot map " + path; return false; }
+        mapped = true;
+#else
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) { err = "cannot open " + path; return false; }
+        fseek(f, 0, SEEK_END);
+        copy.resize((size_t)std::max(0L, ftell(f)));
+        fseek(f, 0, SEEK_SET);
+        bool ok = fread(copy.data(), 1, copy.size(), f) == copy.size();
+        fclose(f);
+        if (!ok) { copy.clear(); err = "cannot read " + path; return false; }
+        base = copy.data();
+        size = copy.size();
+#endif
+        if (!valid(err)) { err = path + ": " + err; close(); return false; }
+        return true;
+    }
+
+    void close()
+    {
+#ifdef MESH_FILE_MMAP
+        if (mapped) munmap((void*)base, size);
+#endif
+        mapped = false;
+        copy.clear();
+        base = nullptr;
+        size = 0;
+    }
+
+    bool loaded() const { return base != nullptr; }
+    const MeshFileHeader& header() const { return *(const MeshFileHeader*)base; }
+    const uint8_t* vertices() const { return base + header().vertexOffset; }
+    const uint8_t* indices() const { return base + header().indexOffset; }
+    const MeshletRecord* meshlets() const { return (const MeshletRecord*)(base + header().meshletOffset); }
+
+    // The part of the file that goes to the GPU: vertices through indices
+    const uint8_t* gpuData() const { return vertices(); }
+    size_t gpuSize() const { return header().indexOffset + (size_t)header().indexCount * header().indexSize - header().vertexOffset; }
+
+    // Triangle corners as pos + normal floats, the CUBE_VERTS layout, for
+    // the software rasterizer
+    std::vector<float> corners() const
+    {
+        const MeshFileHeader& h = header();
+        std::vector<float> out;
+        out.reserve(h.indexCount * 6);
+        for (uint32_t i = 0; i < h.indexCount; i++) {
+            uint32_t v = h.indexSize == 2 ? ((const uint16_t*)indices())[i] : ((const uint32_t*)indices())[i];
+            const uint8_t* p = vertices() + (size_t)v * h.vertexStride;
+            uint16_t hp[3];
+            uint32_t n;
+            memcpy(hp, p, sizeof hp);
+            memcpy(&n, p + 8, sizeof n);
+            for (int k = 0; k < 3; k++) out.push_back(halfToFloat(hp[k]));
+            for (int k = 0; k < 3; k++) out.push_back(snorm10((n >> (10 * k)) & 0x3FF));
+        }
+        return out;
+    }
+
+private:
+    bool valid(std::string& err) const
+    {
+        if (size < sizeof(MeshFileHeader)) { err = "too short for a mesh header"; return false; }
+        const MeshFileHeader& h = header();
+        if (memcmp(h.magic, "KSMS", 4) != 0) { err = "not a baked mesh"; return false; }
+        if (h.version != VERSION) { err = "mesh version " + std::to_string(h.version) + ", expected " + std::to_string(VERSION); return false; }
+        if (h.vertexStride != STRIDE) { err = "unsupported vertex layout"; return false; }
+        if (h.indexSize != 2 && h.indexSize != 4) { err = "bad index size"; return false; }
+        if (h.indexSize == 2 && h.vertexCount > 65536) { err = "u16 indices for more than 65536 vertices"; return false; }
+        if (h.vertexCount == 0 || h.indexCount == 0 || h.indexCount % 3) { err = "no triangles"; return false; }
+        if (h.vertexOffset % 64 || h.indexOffset % 64) { err = "sections not 64-byte aligned"; return false; }
+        uint64_t vEnd = h.vertexOffset + (uint64_t)h.vertexCount * h.vertexStride;
+        uint64_t iEnd = h.indexOffset + (uint64_t)h.indexCount * h.indexSize;
+        if (h.vertexOffset < sizeof(MeshFileHeader) || vEnd > h.indexOffset || iEnd > size) { err = "sections outside the file"; return false; }
+        // Out-of-range indices would read past the buffer on the GPU
+        for (uint32_t i = 0; i < h.indexCount; i++) {
+            uint32_t v = h.indexSize == 2 ? ((const uint16_t*)indices())[i] : ((const uint32_t*)indices())[i];
+            if (v >= h.vertexCount) { err = "index out of range"; return false; }
+        }
+        if (h.meshletCount) {
+            uint64_t mEnd = h.meshletOffset + (uint64_t)h.meshletCount * sizeof(MeshletRecord);
+            if (h.meshletOffset % 64 || h.meshletOffset < iEnd || mEnd > size) { err = "meshlets outside the file"; return false; }
+            for (uint32_t i = 0; i < h.meshletCount; i++) {
+                const MeshletRecord& r = meshlets()[i];
+                if (r.firstIndex % 3 || r.indexCount % 3 || r.indexCount == 0 || r.indexCount > MESHLET_TRIANGLES * 3
+                    || (uint64_t)r.firstIndex + r.indexCount > h.indexCount) { err = "meshlet range out of bounds"; return false; }
+            }
+        }
+        return true;
+    }
+
+    static float halfToFloat(uint16_t h)
+    {
+        uint32_t sign = (uint32_t)(h & 0x8000) << 16, e = (h >> 10) & 0x1F, m = h & 0x3FF, bits;
+        if (e == 0) {
+            if (m == 0) bits = sign;
+            else {                      // subnormal: renormalise
+                e = 113;
+                while (!(m & 0x400)) { m <<= 1; e--; }
+                bits = sign | (e << 23) | ((m & 0x3FF) << 13);
+            }
+        }
+        else if (e == 31) bits = sign | 0x7F800000 | (m << 13);
+        else bits = sign | ((e + 112) << 23) | (m << 13);
+        float f;
+        memcpy(&f, &bits, sizeof f);
+        return f;
+    }
+
+    // GL's signed normalized conversion: max(c / 511, -1)
+    static float snorm10(uint32_t v)
+    {
+        int c = v & 0x200 ? (int)v - 1024 : (int)v;
+        return std::max(c / 511.f, -1.f);
+    }
+
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    bool   mapped = false;
+    std::vector<uint8_t> copy;      // without mmap
+};
@@ -7,9 +7,40 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <cfloat>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "anim_lod.h"
+#include "antialias.h"
+#include "async_task.h"
+#include "command_queue.h"
+#include "fast_trig.h"
+#include "gl_backend.h"
+#include "gl_util.h"
+#include "input_replay.h"
+#include "mesh_file.h"
+#include "phasor_anim.h"
+#include "reduced_lighting.h"
+#include "renderer.h"
+#include "scene.h"
+#include "sculpture.h"
+#include "soft_raster.h"
+#include "spatial_grid.h"
+#include "temporal_cache.h"
+#include "wave_solver.h"
 
 // ─────────────────────────────────────────────────────────────────────────────
 //  Inline shader sources
@@ -19,30 +50,197 @@ static const char* VERT_SRC = R"GLSL(
 #version 330 core
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aBase;     // grid x, z
+layout(location = 3) in vec4 aState0;   // gy, spin, scale, animTime
+layout(location = 4) in vec4 aState1;
 
 out vec3 FragPos;
 out vec3 Normal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat4  view;
+uniform mat4  projection;
+uniform float animTime;
+
+#ifdef MOTION_VECTORS
+layout(location = 5) in vec4 aPrev0;    // state pair as of the previous frame
+layout(location = 6) in vec4 aPrev1;
+uniform mat4  curViewProj;     // unjittered, so TAA jitter is not motion
+uniform mat4  prevViewProj;
+uniform float prevAnimTime;
+out vec4 CurClip;
+out vec4 PrevClip;
+#endif
+
+// translate(gx, gy, gz) * rotateY(spin) * scale(s), with the animation LOD
+// state interpolated between the two stored states at time t
+vec3 place(vec3 p, vec4 s0, vec4 s1, float t, out mat3 rot)
+{
+    float span = s1.w - s0.w;
+    float f    = span > 0.0 ? clamp((t - s0.w) / span, 0.0, 1.0) : 1.0;
+    vec3  st   = mix(s0.xyz, s1.xyz, f);
+
+    float a = radians(st.y);
+    rot = mat3(cos(a), 0.0, -sin(a),  0.0, 1.0, 0.0,  sin(a), 0.0, cos(a));
+    return rot * (p * st.z) + vec3(aBase.x, st.x, aBase.y);
+}
+
+void main()
+{
+    mat3 rot;
+    FragPos     = place(aPos, aState0, aState1, animTime, rot);
+    Normal      = rot * aNormal;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+
+#ifdef MOTION_VECTORS
+    mat3 prevRot;
+    CurClip  = curViewProj * vec4(FragPos, 1.0);
+    PrevClip = prevViewProj * vec4(place(aPos, aPrev0, aPrev1, prevAnimTime, prevRot), 1.0);
+#endif
+}
+)GLSL";
+
+// Multi-draw variant: one draw per command, instance data from SSBOs
+static const char* INDIRECT_VERT = R"GLSL(
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+
+struct DrawData {
+    mat4 model;
+    vec4 colour;    // a = 1: unlit light marker
+};
+layout(std430, binding = 0) readonly buffer Draws  { DrawData draws[]; };
+layout(std430, binding = 1) readonly buffer Bases  { vec2 bases[]; };
+layout(std430, binding = 2) readonly buffer States { vec4 states[]; };  // two per instance
+
+out vec3 FragPos;
+out vec3 Normal;
+flat out vec4 Emissive;
+
+uniform mat4  view;
+uniform mat4  projection;
+uniform float animTime;
+uniform int   drawBase;     // first DrawData of this multi-draw
+uniform bool  oneDraw;      // every draw uses draws[drawBase] (meshlet draws)
 
 void main()
 {
-    FragPos     = vec3(model * vec4(aPos, 1.0));
-    Normal      = mat3(transpose(inverse(model))) * aNormal;
+    DrawData d = draws[oneDraw ? drawBase : drawBase + gl_DrawIDARB];
+    Emissive = d.colour;
+    if (d.colour.a > 0.0) {
+        FragPos = vec3(d.model * vec4(aPos, 1.0));
+        Normal  = aNormal;
+    }
+    else {
+        int  i  = gl_BaseInstanceARB + gl_InstanceID;
+        vec4 s0 = states[i * 2], s1 = states[i * 2 + 1];
+        float span = s1.w - s0.w;
+        float f    = span > 0.0 ? clamp((animTime - s0.w) / span, 0.0, 1.0) : 1.0;
+        vec3  st   = mix(s0.xyz, s1.xyz, f);
+
+        float a   = radians(st.y);
+        mat3  rot = mat3(cos(a), 0.0, -sin(a),  0.0, 1.0, 0.0,  sin(a), 0.0, cos(a));
+        FragPos = rot * (aPos * st.z) + vec3(bases[i].x, st.x, bases[i].y);
+        Normal  = rot * aNormal;
+    }
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
 )GLSL";
 
+// Meshlet culling: one invocation per (visible instance, meshlet) pair,
+// instances numbered through the visible runs. Survivors of the frustum
+// and normal-cone tests append a draw of their index range; clearTail
+// empties the commands past the last survivor.
+static const char* MESHLET_CULL_COMP = R"GLSL(
+#version 430 core
+layout(local_size_x = 64) in;
+
+struct Meshlet {
+    vec4  sphere;   // centre, radius
+    vec4  cone;     // axis, cutoff
+    uvec4 range;    // first index, index count
+};
+struct DrawCommand {
+    uint count, instanceCount, firstIndex;
+    int  baseVertex;
+    uint baseInstance;
+};
+layout(std430, binding = 1) readonly buffer Bases    { vec2 bases[]; };
+layout(std430, binding = 2) readonly buffer States   { vec4 states[]; };
+layout(std430, binding = 3) readonly buffer Meshlets { Meshlet meshlets[]; };
+layout(std430, binding = 4) readonly buffer Runs     { uvec4 runs[]; };    // first instance, count, first slot
+layout(std430, binding = 5) buffer Commands { DrawCommand cmds[]; };
+layout(std430, binding = 6) buffer Counters { uint drawn, outside, backFacing; };
+
+uniform vec4  planes[6];
+uniform vec3  viewPos;
+uniform float animTime;
+uniform int   meshletCount, indexBase, pairs, runCount;
+uniform bool  clearTail;
+
+void main()
+{
+    uint p = gl_GlobalInvocationID.x;
+    if (p >= uint(pairs)) return;
+    if (clearTail) {
+        if (p >= drawn) cmds[p].instanceCount = 0u;
+        return;
+    }
+    uint slot = p / uint(meshletCount), m = p - slot * uint(meshletCount);
+    int lo = 0, hi = runCount;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (runs[mid].z <= slot) lo = mid; else hi = mid;
+    }
+    uint i = runs[lo].x + slot - runs[lo].z;
+
+    vec4 s0 = states[i * 2u], s1 = states[i * 2u + 1u];
+    float span = s1.w - s0.w;
+    float f    = span > 0.0 ? clamp((animTime - s0.w) / span, 0.0, 1.0) : 1.0;
+    vec3  st   = mix(s0.xyz, s1.xyz, f);
+    float a    = radians(st.y);
+    mat3  rot  = mat3(cos(a), 0.0, -sin(a),  0.0, 1.0, 0.0,  sin(a), 0.0, cos(a));
+
+    Meshlet ml = meshlets[m];
+    vec3  c = rot * (ml.sphere.xyz * st.z) + vec3(bases[i].x, st.x, bases[i].y);
+    float r = ml.sphere.w * st.z;
+    for (int k = 0; k < 6; k++)
+        if (dot(planes[k].xyz, c) + planes[k].w < -r) { atomicAdd(outside, 1u); return; }
+    vec3 d = c - viewPos;
+    if (dot(d, rot * ml.cone.xyz) >= ml.cone.w * length(d) + r) { atomicAdd(backFacing, 1u); return; }
+    cmds[atomicAdd(drawn, 1u)] = DrawCommand(ml.range.y, 1u, uint(indexBase) + ml.range.x, 0, i);
+}
+)GLSL";
+
 static const char* FRAG_SRC = R"GLSL(
 #version 330 core
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
 
 in vec3 FragPos;
 in vec3 Normal;
 
-#define NR_POINT_LIGHTS 4
+#ifdef INDIRECT
+flat in vec4 Emissive;
+#endif
+
+#ifdef MOTION_VECTORS
+in vec4 CurClip;
+in vec4 PrevClip;
+layout(location = 1) out vec2 Velocity;   // uv this frame minus uv last frame
+#endif
+
+#ifdef TEMPORAL_CACHE
+uniform sampler2D history;      // rgb = last frame's lit colour, a = view depth
+uniform int       shadePhase;   // which quarter of the 8x8 tiles is re-shaded
+uniform bool      historyValid;
+#endif
+
+#ifdef LOW_RES_LIGHTING
+layout(location = 1) out vec4 NormalOut;    // for the bilateral upsample
+#endif
+
+#define MAX_POINT_LIGHTS 256
 
 struct DirLight {
     vec3 direction;
@@ -76,12 +274,23 @@ struct SpotLight {
 
 uniform vec3       viewPos;
 uniform DirLight   dirLight;
-uniform PointLight pointLights[NR_POINT_LIGHTS];
 uniform SpotLight  spotLight;
 uniform vec3       matDiffuse;
 uniform vec3       matSpecular;
 uniform float      matShininess;
 
+// Point lights in a uniform block, four vec4 each: position + constant,
+// ambient + linear, diffuse + quadratic, specular
+layout(std140) uniform PointLightBlock { vec4 pointLightData[MAX_POINT_LIGHTS * 4]; };
+uniform int pointLightCount;
+
+PointLight pointLight(int i)
+{
+    vec4 a = pointLightData[i * 4],     b = pointLightData[i * 4 + 1];
+    vec4 c = pointLightData[i * 4 + 2], d = pointLightData[i * 4 + 3];
+    return PointLight(a.xyz, a.w, b.w, c.w, b.xyz, c.xyz, d.xyz);
+}
+
 vec3 CalcDirLight(DirLight L, vec3 n, vec3 v)
 {
     vec3  d    = normalize(-L.direction);
@@ -124,15 +333,53 @@ vec3 CalcSpotLight(SpotLight L, vec3 n, vec3 fp, vec3 v)
 
 void main()
 {
+#ifdef INDIRECT
+    if (Emissive.a > 0.0) { FragColor = vec4(Emissive.rgb, 1.0); return; }
+#endif
+
+#ifdef GBUFFER
+    // Normal/depth prepass for reduced-resolution lighting: no shading
+    FragColor = vec4(normalize(Normal), 1.0 / gl_FragCoord.w);
+    return;
+#endif
+
+#ifdef MOTION_VECTORS
+    vec2 uv     = CurClip.xy / CurClip.w * 0.5 + 0.5;
+    vec2 prevUv = PrevClip.xy / PrevClip.w * 0.5 + 0.5;
+    Velocity = uv - prevUv;
+#endif
+
+#ifdef TEMPORAL_CACHE
+    // Re-shade one tile class per frame; tiles are 8x8 so whole GPU quads and
+    // warps take the same branch. Everything else reuses last frame's result
+    // when the surface it reprojects to was visible there at the same depth.
+    ivec2 tile = ivec2(gl_FragCoord.xy) >> 3;
+    bool  due  = ((tile.x & 1) | ((tile.y & 1) << 1)) == shadePhase;
+    if (!due && historyValid && all(greaterThanEqual(prevUv, vec2(0.0))) && all(lessThan(prevUv, vec2(1.0)))) {
+        vec4 h = texture(history, prevUv);
+        if (abs(h.a - PrevClip.w) < 0.02 * PrevClip.w) {
+            FragColor = vec4(h.rgb, CurClip.w);
+            return;
+        }
+    }
+#endif
+
     vec3 n = normalize(Normal);
     vec3 v = normalize(viewPos - FragPos);
 
     vec3 c = CalcDirLight(dirLight, n, v);
-    for (int i = 0; i < NR_POINT_LIGHTS; i++)
-        c += CalcPointLight(pointLights[i], n, FragPos, v);
+    for (int i = 0; i < pointLightCount; i++)
+        c += CalcPointLight(pointLight(i), n, FragPos, v);
     c += CalcSpotLight(spotLight, n, FragPos, v);
 
     FragColor = vec4(c, 1.0);
+#ifdef MOTION_VECTORS
+    FragColor.a = CurClip.w;
+#endif
+#ifdef LOW_RES_LIGHTING
+    FragColor.a = 1.0 / gl_FragCoord.w;
+    NormalOut   = vec4(n, 0.0);
+#endif
 }
 )GLSL";
 
@@ -143,61 +390,41 @@ layout(location = 0) in vec3 aPos;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+#ifdef MOTION_VECTORS
+uniform mat4 curViewProj;
+uniform mat4 prevMVP;
+out vec4 CurClip;
+out vec4 PrevClip;
+#endif
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
+#ifdef MOTION_VECTORS
+    CurClip  = curViewProj * model * vec4(aPos, 1.0);
+    PrevClip = prevMVP * vec4(aPos, 1.0);
+#endif
 }
 )GLSL";
 
 static const char* LIGHT_FRAG = R"GLSL(
 #version 330 core
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
 uniform vec3 lightColor;
+#ifdef MOTION_VECTORS
+in vec4 CurClip;
+in vec4 PrevClip;
+layout(location = 1) out vec2 Velocity;
+#endif
 void main()
 {
     FragColor = vec4(lightColor, 1.0);
+#ifdef MOTION_VECTORS
+    FragColor.a = CurClip.w;
+    Velocity = (CurClip.xy / CurClip.w - PrevClip.xy / PrevClip.w) * 0.5;
+#endif
 }
 )GLSL";
 
-// ─────────────────────────────────────────────────────────────────────────────
-//  Shader helper
-// ─────────────────────────────────────────────────────────────────────────────
-static GLuint compileShader(GLenum type, const char* src)
-{
-    GLuint id = glCreateShader(type);
-    glShaderSource(id, 1, &src, nullptr);
-    glCompileShader(id);
-    GLint ok; glGetShaderiv(id, GL_COMPILE_STATUS, &ok);
-    if (!ok) {
-        char log[1024]; glGetShaderInfoLog(id, 1024, nullptr, log);
-        std::cerr << "[SHADER ERROR] " << log << "\n";
-    }
-    return id;
-}
-
-static GLuint makeProgram(const char* vsrc, const char* fsrc)
-{
-    GLuint vs = compileShader(GL_VERTEX_SHADER, vsrc);
-    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fsrc);
-    GLuint prog = glCreateProgram();
-    glAttachShader(prog, vs); glAttachShader(prog, fs);
-    glLinkProgram(prog);
-    GLint ok; glGetProgramiv(prog, GL_LINK_STATUS, &ok);
-    if (!ok) {
-        char log[1024]; glGetProgramInfoLog(prog, 1024, nullptr, log);
-        std::cerr << "[LINK ERROR] " << log << "\n";
-    }
-    glDeleteShader(vs); glDeleteShader(fs);
-    return prog;
-}
-
-// ─────────────────────────────────────────────────────────────────────────────
-//  Uniform setters
-// ─────────────────────────────────────────────────────────────────────────────
-static void setFloat(GLuint p, const char* n, float v) { glUniform1f(glGetUniformLocation(p, n), v); }
-static void setVec3(GLuint p, const char* n, glm::vec3 v) { glUniform3fv(glGetUniformLocation(p, n), 1, glm::value_ptr(v)); }
-static void setMat4(GLuint p, const char* n, const glm::mat4& m) { glUniformMatrix4fv(glGetUniformLocation(p, n), 1, GL_FALSE, glm::value_ptr(m)); }
-
 // ─────────────────────────────────────────────────────────────────────────────
 //  Camera (simple FPS)
 // ─────────────────────────────────────────────────────────────────────────────
@@ -228,62 +455,685 @@ struct Camera {
 // ─────────────────────────────────────────────────────────────────────────────
 //  Globals
 // ─────────────────────────────────────────────────────────────────────────────
-const int SCR_W = 1280, SCR_H = 720;
-float lastX = SCR_W / 2.f, lastY = SCR_H / 2.f;
+const float SPACING = 2.2f;         // cube pitch in the sculpture grid
+int   scrW = 1280, scrH = 720;      // window size, --size WxH
+float lastX = scrW / 2.f, lastY = scrH / 2.f;
 bool  firstMouse = true;
 float dt = 0, lastFrame = 0;
 bool  paused = false;
 float animTime = 0;
+bool  useWave = false;      // CPU heightfield drives gy instead of the sine sum
+bool  waveDrop = false;     // one-shot request for a random ripple
+bool  useLod = false;       // animation LOD for distant cube regions
+bool  viewportDirty = true; // window resized or exposed, last frame is stale
+bool  useCache = false;     // temporal reprojection cache for lighting
+AaMode aaMode = AaMode::None;
+int   lightingScale = 1;    // lighting at 1/N resolution (1, 2 or 4)
+bool  useIndirect = true;   // multi-draw indirect where GL 4.3 allows it
+int   lightCount = 4;       // point lights in the rig
+bool  useCull = true;       // frustum-cull sculpture regions
+bool  usePhasor = true;     // incremental waves while every cube updates each frame
+LoopExec animExec = LoopExec::Pool;     // how the unLODed cube loop runs
+bool  usePin = true;        // pin pool threads to CPUs, --no-pin
+CpuTopology cpuTopo;        // detected before anything is pinned
+std::string meshPath;       // --mesh: baked sculpture element instead of the cube
+bool  useMeshlets = true;   // GPU meshlet culling for baked meshes that carry meshlets
+CommandQueue<1024> commands;        // input and control, drained by the render loop
+InputRecorder inputLog;     // --record
+InputReplay   inputReplay;  // --replay / --replay-fast
+uint16_t      replayKeys = 0;
+
+// Keys a session log records, one bit each
+static const int SESSION_KEYS[] = { GLFW_KEY_ESCAPE, GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_SPACE,
+                                    GLFW_KEY_H, GLFW_KEY_R, GLFW_KEY_L, GLFW_KEY_C, GLFW_KEY_T, GLFW_KEY_G };
+
+// Far plane grows with the sculpture
+glm::mat4 sceneProjection(float zoom, int grid)
+{
+    return glm::perspective(glm::radians(zoom), (float)scrW / scrH, 0.1f, std::max(120.f, grid * SPACING * 1.5f));
+}
 
-void framebuffer_size_callback(GLFWwindow*, int w, int h) { glViewport(0, 0, w, h); }
+void framebuffer_size_callback(GLFWwindow*, int w, int h) { glViewport(0, 0, w, h); viewportDirty = true; }
+void window_refresh_callback(GLFWwindow*) { viewportDirty = true; }
 
 void mouse_callback(GLFWwindow*, double xd, double yd)
 {
     float x = (float)xd, y = (float)yd;
+    if (inputLog.active()) inputLog.cursor(x, y);
     if (firstMouse) { lastX = x; lastY = y; firstMouse = false; }
-    cam.look(x - lastX, lastY - y);
+    commands.push({ Command::Look, x - lastX, lastY - y });
     lastX = x; lastY = y;
 }
 
 void scroll_callback(GLFWwindow*, double, double yo)
 {
-    cam.zoom = glm::clamp(cam.zoom - (float)yo, 1.0f, 90.0f);
+    if (inputLog.active()) inputLog.scroll((float)yo);
+    commands.push({ Command::Zoom, (float)yo });
+}
+
+// Live keyboard, or the replayed frame's held keys
+static bool keyDown(GLFWwindow* w, int key)
+{
+    if (!inputReplay.active()) return glfwGetKey(w, key) == GLFW_PRESS;
+    for (size_t i = 0; i < std::size(SESSION_KEYS); i++)
+        if (SESSION_KEYS[i] == key) return (replayKeys >> i) & 1;
+    return false;
+}
+
+static uint16_t heldKeys(GLFWwindow* w)
+{
+    uint16_t keys = 0;
+    for (size_t i = 0; i < std::size(SESSION_KEYS); i++)
+        if (keyDown(w, SESSION_KEYS[i])) keys |= 1 << i;
+    return keys;
+}
+
+// Edge-triggered key check for toggles
+static bool pressed(GLFWwindow* w, int key)
+{
+    static bool prev[GLFW_KEY_LAST + 1] = {};
+    bool cur = keyDown(w, key);
+    bool hit = cur && !prev[key];
+    prev[key] = cur;
+    return hit;
 }
 
 void processInput(GLFWwindow* w)
 {
-    if (glfwGetKey(w, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(w, true);
-    if (glfwGetKey(w, GLFW_KEY_W) == GLFW_PRESS) cam.moveForward(dt);
-    if (glfwGetKey(w, GLFW_KEY_S) == GLFW_PRESS) cam.moveBackward(dt);
-    if (glfwGetKey(w, GLFW_KEY_A) == GLFW_PRESS) cam.moveLeft(dt);
-    if (glfwGetKey(w, GLFW_KEY_D) == GLFW_PRESS) cam.moveRight(dt);
-
-    static int prev = GLFW_RELEASE;
-    int cur = glfwGetKey(w, GLFW_KEY_SPACE);
-    if (cur == GLFW_PRESS && prev == GLFW_RELEASE) paused = !paused;
-    prev = cur;
+    if (keyDown(w, GLFW_KEY_ESCAPE)) commands.push({ Command::Quit });
+    if (keyDown(w, GLFW_KEY_W)) commands.push({ Command::MoveForward, dt });
+    if (keyDown(w, GLFW_KEY_S)) commands.push({ Command::MoveBackward, dt });
+    if (keyDown(w, GLFW_KEY_A)) commands.push({ Command::MoveLeft, dt });
+    if (keyDown(w, GLFW_KEY_D)) commands.push({ Command::MoveRight, dt });
+
+    if (pressed(w, GLFW_KEY_SPACE)) commands.push({ Command::TogglePause });
+    if (pressed(w, GLFW_KEY_H)) commands.push({ Command::ToggleWave });
+    if (pressed(w, GLFW_KEY_R)) commands.push({ Command::DropWave });
+    if (pressed(w, GLFW_KEY_L)) commands.push({ Command::ToggleLod });
+    if (pressed(w, GLFW_KEY_C)) commands.push({ Command::ToggleCache });
+    if (pressed(w, GLFW_KEY_T)) commands.push({ Command::CycleAa });
+    if (pressed(w, GLFW_KEY_G)) commands.push({ Command::CycleLightingScale });
+}
+
+// Render thread: everything queued since the last frame, in order
+static void applyCommands(GLFWwindow* w)
+{
+    commands.drain([&](const Command& c) {
+        switch (c.type) {
+        case Command::Quit:               glfwSetWindowShouldClose(w, true); break;
+        case Command::MoveForward:        cam.moveForward(c.a); break;
+        case Command::MoveBackward:       cam.moveBackward(c.a); break;
+        case Command::MoveLeft:           cam.moveLeft(c.a); break;
+        case Command::MoveRight:          cam.moveRight(c.a); break;
+        case Command::Look:               cam.look(c.a, c.b); break;
+        case Command::Zoom:               cam.zoom = glm::clamp(cam.zoom - c.a, 1.0f, 90.0f); break;
+        case Command::TogglePause:        paused = !paused; break;
+        case Command::ToggleWave:         useWave = !useWave; break;
+        case Command::DropWave:           waveDrop = true; break;
+        case Command::ToggleLod:          useLod = !useLod; break;
+        case Command::ToggleCache:        useCache = !useCache; break;
+        case Command::CycleAa:            aaMode = AaMode(((int)aaMode + 1) % 4); break;
+        case Command::CycleLightingScale: lightingScale = lightingScale == 4 ? 1 : lightingScale * 2; break;
+        }
+    });
+    static unsigned long long reported = 0;
+    if (commands.dropped() > reported) {
+        std::cerr << "Command queue full: " << commands.dropped() - reported << " camera inputs dropped\n";
+        reported = commands.dropped();
+    }
+}
+
+// Shader variant streamed in: sources assembled on an IO thread, compiled
+// and linked by the GL thread's pump, then handed to ready there
+static Task<void> loadProgram(AsyncLoader& loader, const char* vs, const char* fs, std::string defines,
+                              std::function<void(GLuint)> ready)
+{
+    co_await loader.background();
+    std::string v = withDefines(vs, defines), f = withDefines(fs, defines);
+    co_await loader.glThread();
+    ready(makeProgram(v.c_str(), f.c_str()));
+}
+
+// Counts and size for the log; culling and spacing assume a unit cube, so
+// say so when the mesh reaches past it
+static void logMesh(const MappedMesh& m)
+{
+    const MeshFileHeader& h = m.header();
+    std::cout << "Mesh: " << meshPath << ", " << h.vertexCount << " vertices, " << h.indexCount / 3 << " triangles, "
+              << h.indexSize * 8 << "-bit indices, " << h.meshletCount << " meshlets, " << m.gpuSize() << " bytes\n";
+    for (int k = 0; k < 3; k++)
+        if (h.boundsMin[k] < -0.5f - 1e-3f || h.boundsMax[k] > 0.5f + 1e-3f) {
+            std::cerr << "Mesh " << meshPath << " reaches outside the unit cube: region culling may drop parts of it\n";
+            break;
+        }
+}
+
+// Baked mesh: mapped and checked (and decoded for the software backend,
+// the corners) on an IO thread, handed to ready by the GL thread's pump.
+// The cube stands in until then, and for good on failure.
+static Task<void> loadMesh(AsyncLoader& loader, std::function<void(const MappedMesh&, std::vector<float>&)> ready)
+{
+    co_await loader.background();
+    MappedMesh mesh;
+    std::string err;
+    if (!mesh.open(meshPath, err)) { std::cerr << err << ", drawing cubes\n"; co_return; }
+    std::vector<float> corners = mesh.corners();
+    co_await loader.glThread();
+    logMesh(mesh);
+    ready(mesh, corners);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Worker placement
+//  Only the pool's worker threads get pinned. The main thread is not, so
+//  driver threads started with the GL context and the asset loader's IO
+//  threads keep the process-wide affinity whenever they are created.
+// ─────────────────────────────────────────────────────────────────────────────
+static std::vector<int> poolCpus()
+{
+    return usePin ? cpuTopo.placement() : std::vector<int>();
+}
+
+static void logPool(const WorkerPool& pool)
+{
+    std::cout << "CPU topology: " << cpuTopo.describe() << "\n";
+    if (pool.size() == 1) { std::cout << "Worker pool: no workers, the main (GL) thread runs every slice, nothing pinned\n"; return; }
+    if (pool.cpuOf(0) < 0) { std::cout << "Worker pool: " << pool.size() << " threads, not pinned\n"; return; }
+    std::map<int, std::vector<int>> workers;
+    for (unsigned w = 1; w < pool.size(); w++) workers[cpuTopo.nodeOf(pool.cpuOf(w))].push_back(pool.cpuOf(w));
+    std::cout << "Worker pool: " << pool.size() << " threads, workers pinned, cpu " << pool.cpuOf(0)
+              << " (node " << cpuTopo.nodeOf(pool.cpuOf(0)) << ") kept for the main (GL) thread";
+    for (auto& [node, cpus] : workers) std::cout << ", node " << node << " workers on cpus " << CpuTopology::formatList(cpus);
+    if (pool.pinFailures()) std::cout << " (" << pool.pinFailures() << " threads could not be pinned)";
+    std::cout << "\n";
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Benchmarks
+// ─────────────────────────────────────────────────────────────────────────────
+// Scripted orbit around the sculpture
+static void benchCamera(int frame, int grid)
+{
+    float a = frame * 0.004f, r = grid * SPACING * 0.6f + 14.f;
+    float sa, ca;
+    fast::sincos(a, sa, ca);
+    cam.pos = { r * sa, 8.f + 3.f * fast::sin(a * 3.f), r * ca };
+    cam.front = glm::normalize(-cam.pos);
+}
+
+static int benchWave(int n)
+{
+    WorkerPool pool(poolCpus());
+    WaveSolver wave(n, pool);
+    wave.drop(0.3f, 0.6f, 0.05f, 1.f);
+    for (int i = 0; i < 20; i++) wave.step();
+
+    using clk = std::chrono::steady_clock;
+    auto t0 = clk::now();
+    int steps = 0;
+    double sec = 0;
+    while (sec < 2.0) {
+        wave.step(); steps++;
+        sec = std::chrono::duration<double>(clk::now() - t0).count();
+    }
+    double ms = sec * 1000.0 / steps;
+    std::cout << "[wave] " << n << "x" << n << ", " << pool.size() << " threads: "
+              << ms << " ms/step, " << 1000.0 / ms << " Hz max (target " << wave.rate() << " Hz)\n";
+    return 0;
+}
+
+// Fast trig in the animation: cube height error against libm, the phasor
+// evaluator's drift, and the cost of sincos and of the direct, polynomial
+// and phasor cube paths. tests/fast_trig_test.cpp checks the error bound.
+static int benchTrig(int grid)
+{
+    // evalCube at random cubes of this grid, an hour of animation time
+    std::mt19937 rng(7);
+    SculptureGrid sculpt(grid, SPACING);
+    std::uniform_int_distribution<int> cube(0, sculpt.count() - 1);
+    std::uniform_real_distribution<float> hour(0.f, 3600.f);
+    double gyErr = 0;
+    for (int i = 0; i < 1000000; i++) {
+        int k = cube(rng);
+        float t = hour(rng), gx = sculpt.gx[k], gz = sculpt.gz[k], d = sculpt.d[k];
+        float ref = 2.0f * sinf(d * 0.55f - t * 2.f) + 0.8f * sinf(gx * 0.5f + t * 1.3f) + 0.8f * cosf(gz * 0.5f - t * 1.1f);
+        gyErr = std::max(gyErr, (double)fabsf(evalCube(gx, gz, d, t).gy - ref));
+    }
+
+    // Phasors stepped at 60 Hz for ten minutes; both paths against the
+    // waves in double precision (the direct path's float arguments lose
+    // precision as t grows, the phasors mostly do not)
+    SculptureGrid small(32, SPACING);
+    PhasorAnim drift(small);
+    drift.reset(0.f);
+    double phasorErr = 0, directErr = 0;
+    for (int f = 1; f <= 36000; f++) {
+        float t = f / 60.f;
+        drift.advance(t);
+        if (f % 100) continue;
+        double td = f / 60.0;
+        for (int i = 0; i < small.count(); i++) {
+            double gx = small.gx[i], gz = small.gz[i], d = small.d[i];
+            double gy = 2.0 * sin(d * 0.55 - td * 2.0) + 0.8 * sin(gx * 0.5 + td * 1.3) + 0.8 * cos(gz * 0.5 - td * 1.1);
+            phasorErr = std::max(phasorErr, fabs(drift.cube(i).gy - gy));
+            directErr = std::max(directErr, fabs(evalCube(small.gx[i], small.gz[i], small.d[i], t).gy - gy));
+        }
+    }
+
+    // Cost per call over the sculpture's cubes
+    using clk = std::chrono::steady_clock;
+    int n = sculpt.count(), reps = std::max(1, 20000000 / n);
+    float sink = 0;
+    auto time = [&](auto&& body) {
+        auto t0 = clk::now();
+        for (int r = 0; r < reps; r++) body(r * 0.016f);
+        return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / ((double)reps * n);
+    };
+    double libmNs = time([&](float t) { for (int i = 0; i < n; i++) sink += sinf(sculpt.d[i] - t) + cosf(sculpt.d[i] - t); });
+    double fastNs = time([&](float t) {
+        for (int i = 0; i < n; i++) { float s, c; fast::sincos(sculpt.d[i] - t, s, c); sink += s + c; }
+    });
+    double oldCubeNs = time([&](float t) {
+        for (int i = 0; i < n; i++) {
+            float gx = sculpt.gx[i], gz = sculpt.gz[i], d = sculpt.d[i];
+            sink += 2.0f * sinf(d * 0.55f - t * 2.f) + 0.8f * sinf(gx * 0.5f + t * 1.3f)
+                  + 0.8f * cosf(gz * 0.5f - t * 1.1f) + 0.12f * sinf(t * 3.f + d);
+        }
+    });
+    double cubeNs = time([&](float t) {
+        for (int i = 0; i < n; i++) {
+            CubeState c = evalCube(sculpt.gx[i], sculpt.gz[i], sculpt.d[i], t);
+            sink += c.gy + c.s;
+        }
+    });
+
+    CubeWaves waves(sculpt);
+    std::vector<CubeState> states(n);
+    double sepNs = time([&](float t) {
+        waves.frame(t);
+        for (int r = 0; r < sculpt.regions(); r++)
+            waves.eval(sculpt.regionStart[r], sculpt.regionStart[r + 1], t, &states[sculpt.regionStart[r]]);
+        sink += states[n / 2].gy;
+    });
+    // Measured sincos per timed frame, by where they were spent
+    double tableTrig = (double)waves.tableTrig / reps, classTrig = (double)waves.classTrig / reps, cubeTrig = (double)waves.cubeTrig / reps;
+    // Off-frame times use per-region tables; both match evalCube bit for bit
+    // unless the compiler contracts multiply-adds differently in the two
+    // (-ffp-contract=fast with FMA), which moves each wave's argument by up
+    // to an ulp. So: identical, or within a few ulps of the largest argument.
+    int sepExact = 0, sepMismatch = 0;
+    double sepDiff = 0;
+    for (float t : { 0.016f * reps, 12.345f }) {
+        for (int r = 0; r < sculpt.regions(); r++)
+            waves.eval(sculpt.regionStart[r], sculpt.regionStart[r + 1], t, &states[sculpt.regionStart[r]]);
+        for (int i = 0; i < n; i++) {
+            CubeState a = states[i], b = evalCube(sculpt.gx[i], sculpt.gz[i], sculpt.d[i], t);
+            float argTol = 8 * FLT_EPSILON * (t * 3.f + sculpt.d[i] + 4.f), spinTol = 4 * FLT_EPSILON * fabsf(b.spin);
+            double diff = std::max(fabs(a.gy - b.gy), fabs(a.s - b.s));
+            sepExact += a.gy == b.gy && a.spin == b.spin && a.s == b.s;
+            sepMismatch += diff > argTol || fabsf(a.spin - b.spin) > spinTol;
+            sepDiff = std::max(sepDiff, diff);
+        }
+    }
+
+    PhasorAnim phasor(sculpt);
+    phasor.reset(0.f);
+    double phasorNs = time([&](float t) {
+        phasor.advance(t);
+        for (int i = 0; i < n; i++) sink += phasor.cube(i).gy;
+    });
+
+    volatile float keep = sink;     // keeps the timed loops alive
+    (void)keep;
+    bool ok = sepMismatch == 0;
+    // Trig per frame: every wave per cube, the separable tables, then the
+    // d terms per distance class
+    double perCube = 4.0 * n, separable = 2.0 * grid + 2.0 * n, classes = 2.0 * grid + 2.0 * sculpt.classes();
+    std::cout << "[trig] grid " << grid << ": " << sculpt.classes() << " distance classes for " << n << " cubes ("
+              << (double)n / sculpt.classes() << " cubes each)\n";
+    std::cout << "[trig] sincos per frame: " << perCube << " evaluating every wave per cube, " << separable
+              << " with separable tables, " << classes << " with distance classes (" << perCube / classes << "x less)\n";
+    std::cout << "[trig] cube height vs libm: " << gyErr << "\n";
+    std::cout << "[trig] sincos: libm " << libmNs << " ns, fast " << fastNs << " ns\n";
+    std::cout << "[trig] evalCube: libm " << oldCubeNs << " ns, fast 4-wide " << cubeNs << " ns (" << oldCubeNs / cubeNs << "x)\n";
+    std::cout << "[trig] separable: " << sepNs << " ns (" << oldCubeNs / sepNs << "x); sincos per frame: " << tableTrig
+              << " for row/column tables, " << classTrig << " for distance classes, " << cubeTrig << " for individual cubes (amortised "
+              << (tableTrig + classTrig + cubeTrig) / n << " per cube, against 4 direct)\n";
+    std::cout << "[trig] phasor: " << phasorNs << " ns (" << oldCubeNs / phasorNs << "x)\n";
+    std::cout << "[trig] separable vs evalCube: " << sepExact << " of " << 2 * n << " cubes identical, max difference "
+              << sepDiff << ", " << sepMismatch << " past the tolerance\n";
+    std::cout << "[trig] cube height error after 10 min at 60 Hz: phasor " << phasorErr << ", direct " << directErr
+              << " (phasor resync every " << PhasorAnim::RESYNC_STEPS << " steps)\n";
+    if (!ok) std::cout << "[trig] FAILED\n";
+    return ok ? 0 : 1;
+}
+
+// The unLODed cube-state loop under every available backend, for both the
+// table and the phasor evaluators; states must match the serial loop
+static int benchAnim(int grid)
+{
+    WorkerPool pool(poolCpus());
+    logPool(pool);
+    SculptureGrid sculpt(grid, SPACING);
+    AnimLod lod(sculpt, pool);
+    CubeWaves waves(sculpt);
+    PhasorAnim phasor(sculpt);
+    const int FRAMES = std::max(20, 20000000 / sculpt.count());
+    std::vector<InstanceState> serial;
+    bool ok = true;
+
+    for (int phased = 0; phased < 2; phased++) {
+        double serialMs = 0;
+        for (LoopExec e : { LoopExec::Serial, LoopExec::Pool, LoopExec::ParUnseq, LoopExec::OpenMp }) {
+            if (!loopExecAvailable(e)) {
+                std::cout << "[anim] " << loopExecName(e) << ": not compiled in\n";
+                continue;
+            }
+            using clk = std::chrono::steady_clock;
+            double ms = 0;
+            phasor.reset(0.f);
+            for (int f = 1; f <= FRAMES; f++) {
+                float t = f / 60.f;
+                auto t0 = clk::now();
+                if (phased) {
+                    phasor.advance(t);
+                    lod.updateAll([&](int i) { return phasor.cube(i); }, t, 1.f / 60.f, e, pool);
+                }
+                else {
+                    waves.frame(t);
+                    waves.prepare();
+                    lod.updateAll([&](int i) { return waves.at(i); }, t, 1.f / 60.f, e, pool);
+                }
+                ms += std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+            }
+            ms /= FRAMES;
+            int diff = 0;
+            if (e == LoopExec::Serial) { serial.assign(lod.states.begin(), lod.states.end()); serialMs = ms; }
+            else
+                for (int i = 0; i < sculpt.count(); i++)
+                    diff += memcmp(&serial[i], &lod.states[i], sizeof(InstanceState)) != 0;
+            ok = ok && diff == 0;
+            std::cout << "[anim] " << (phased ? "phasor" : "tables") << ", " << loopExecName(e) << ": " << ms
+                      << " ms/frame for " << sculpt.count() << " cubes (" << serialMs / ms << "x serial)";
+            if (diff) std::cout << ", " << diff << " states differ from serial";
+            std::cout << "\n";
+        }
+    }
+    std::cout << "[anim] " << pool.size() << " pool threads, " << FRAMES << " frames each\n";
+    return ok ? 0 : 1;
+}
+
+// Spatial grid against brute force over the animated lights and cubes: the
+// lights reaching each cube and the cubes near each light must come out the
+// same (exit code 1 otherwise); times the incremental update, a rebuild and
+// both queries, at the default light cutoff and a coarser one
+static int benchGrid(int grid)
+{
+    SculptureGrid sculpt(grid, SPACING);
+    SceneDesc scene = makeSculptureScene(lightCount);
+    CubeWaves waves(sculpt);
+    int n = sculpt.count(), lights = (int)scene.pointLights.size();
+    const int FRAMES = std::clamp(50000000 / (n * lights), 5, 240);
+    const float NEAR = 3 * SPACING;     // cubesWithin radius around each light
+    std::vector<CubeState> cubes(n);
+    std::vector<float> y(n);
+    std::vector<int> found, brute;
+    bool ok = true;
+    using clk = std::chrono::steady_clock;
+    auto since = [](clk::time_point t0) { return std::chrono::duration<double, std::milli>(clk::now() - t0).count(); };
+    // Lists ended by -1, in any order within a list against ascending
+    auto sameLists = [](std::vector<int>& a, const std::vector<int>& b) {
+        for (auto s = a.begin(); s != a.end(); ) {
+            auto e = std::find(s, a.end(), -1);
+            std::sort(s, e);
+            s = e == a.end() ? e : e + 1;
+        }
+        return a == b;
+    };
+
+    for (float cutoff : { 1.f / 256, 1.f / 32 }) {
+        SpatialGrid index(sculpt), fresh(sculpt);
+        index.cutoff = fresh.cutoff = cutoff;
+        double updateMs = 0, rebuildMs = 0, lightsMs = 0, bruteLightsMs = 0, nearMs = 0, bruteNearMs = 0, rangeSum = 0;
+        long long pairs = 0, nearPairs = 0, rebuildEdits = 0;
+        int diff = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            float t = (f + 1) / 60.f;
+            animateLights(scene, t);
+            waves.frame(t);
+            waves.eval(0, n, t, cubes.data());
+            for (int i = 0; i < n; i++) y[i] = cubes[i].gy;
+
+            auto t0 = clk::now();
+            index.update(scene.pointLights);
+            updateMs += since(t0);
+            long long before = fresh.cellEdits;
+            t0 = clk::now();
+            fresh.rebuild(scene.pointLights);
+            rebuildMs += since(t0);
+            rebuildEdits += fresh.cellEdits - before;
+            for (int l = 0; l < lights; l++) rangeSum += index.range(l);
+
+            // Lights per cube; the brute force uses the same ranges and test
+            found.clear();
+            t0 = clk::now();
+            for (int i = 0; i < n; i++) {
+                index.lightsAffecting(i, y[i], found);
+                found.push_back(-1);
+            }
+            lightsMs += since(t0);
+            brute.clear();
+            t0 = clk::now();
+            for (int i = 0; i < n; i++) {
+                glm::vec3 c(sculpt.gx[i], y[i], sculpt.gz[i]);
+                for (int l = 0; l < lights; l++) {
+                    glm::vec3 d = scene.pointLights[l].position - c;
+                    float r = index.range(l) + SpatialGrid::CUBE_RADIUS;
+                    if (glm::dot(d, d) <= r * r) brute.push_back(l);
+                }
+                brute.push_back(-1);
+            }
+            bruteLightsMs += since(t0);
+            diff += !sameLists(found, brute);
+            pairs += (long long)brute.size() - n;
+
+            // Cubes near each light
+            found.clear();
+            t0 = clk::now();
+            for (int l = 0; l < lights; l++) {
+                index.cubesWithin(scene.pointLights[l].position, NEAR, y.data(), found);
+                found.push_back(-1);
+            }
+            nearMs += since(t0);
+            brute.clear();
+            t0 = clk::now();
+            for (int l = 0; l < lights; l++) {
+                glm::vec3 p = scene.pointLights[l].position;
+                for (int i = 0; i < n; i++) {
+                    glm::vec3 d(sculpt.gx[i] - p.x, y[i] - p.y, sculpt.gz[i] - p.z);
+                    if (glm::dot(d, d) <= NEAR * NEAR) brute.push_back(i);
+                }
+                brute.push_back(-1);
+            }
+            bruteNearMs += since(t0);
+            diff += !sameLists(found, brute);
+            nearPairs += (long long)brute.size() - lights;
+        }
+        ok = ok && diff == 0;
+        std::cout << "[grid] cutoff 1/" << 1.f / cutoff << ": light range " << rangeSum / ((double)FRAMES * lights)
+                  << ", update " << updateMs / FRAMES << " ms/frame (" << (double)index.cellEdits / FRAMES
+                  << " cell edits), rebuild " << rebuildMs / FRAMES << " ms (" << (double)rebuildEdits / FRAMES
+                  << ")\n[grid]   lights per cube: " << lightsMs / FRAMES << " ms/frame vs " << bruteLightsMs / FRAMES
+                  << " brute force (" << bruteLightsMs / lightsMs << "x), " << (double)pairs / FRAMES / n
+                  << " of " << lights << " lights each\n[grid]   cubes within " << NEAR << " of each light: "
+                  << nearMs / FRAMES << " ms/frame vs " << bruteNearMs / FRAMES << " brute force ("
+                  << bruteNearMs / nearMs << "x), " << (double)nearPairs / FRAMES / lights << " each";
+        if (diff) std::cout << ", " << diff << " frames differ from brute force";
+        std::cout << "\n";
+    }
+    SpatialGrid index(sculpt);
+    std::cout << "[grid] " << grid << "x" << grid << " cubes, " << lights << " lights, " << index.cellsPerSide() << "x"
+              << index.cellsPerSide() << " cells of " << index.cubesPerCell() << "x" << index.cubesPerCell() << " cubes, "
+              << FRAMES << " frames" << (ok ? "\n" : "\n[grid] FAILED\n");
+    return ok ? 0 : 1;
+}
+
+// Same orbit and animation as --bench, drawn by the software rasterizer
+// without a GL context
+static int benchSoftware(int grid, int frames, bool useLod, const std::string& ppm)
+{
+    WorkerPool pool(poolCpus());
+    SculptureGrid sculpt(grid, SPACING);
+    AnimLod lod(sculpt, pool);
+    std::vector<glm::vec2> base(sculpt.count());
+    for (int i = 0; i < sculpt.count(); i++) base[i] = { sculpt.gx[i], sculpt.gz[i] };
+
+    SceneDesc scene = makeSculptureScene(lightCount);
+    scene.count = sculpt.count();
+    scene.base = base.data();
+    scene.states = lod.states.data();
+    SoftRasterizer raster(scrW, scrH, pool);
+    if (!meshPath.empty()) {
+        MappedMesh mesh;
+        std::string err;
+        if (mesh.open(meshPath, err)) { raster.setMesh(mesh.corners()); logMesh(mesh); }
+        else std::cerr << err << ", drawing cubes\n";
+    }
+    SceneRecorder recorder(sculpt, pool);
+    recorder.cull = useCull;
+
+    CubeWaves waves(sculpt);
+    auto eval = [&](int lo, int hi, float t, CubeState* out) { waves.eval(lo, hi, t, out); };
+    using clk = std::chrono::steady_clock;
+    double ms = 0;
+    int timed = 0;
+    for (int f = 0; f < frames; f++) {
+        float t = (f + 1) / 60.f;
+        benchCamera(f, grid);
+        auto t0 = clk::now();
+        waves.frame(t);
+        lod.update(eval, t, 1.f / 60.f, useLod, cam.pos, cam.front, cam.zoom, scrH);
+        animateLights(scene, t);
+        setCamera(scene, cam.view(), sceneProjection(cam.zoom, grid), cam.pos, cam.front);
+        scene.animTime = t;
+        raster.submit(scene, recorder.record(scene));
+        if (f >= 10) {
+            ms += std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+            timed++;
+        }
+    }
+    std::cout << "[soft] " << frames << " frames, " << grid << "x" << grid << " cubes, " << lightCount << " lights, " << scrW << "x" << scrH
+              << ", " << pool.size() << " threads: " << ms / std::max(timed, 1) << " ms/frame, " << raster.triangles() << " triangles, "
+              << recorder.visibleRegions << "/" << sculpt.regions() << " regions in view\n";
+    if (!ppm.empty()) {
+        if (raster.writePpm(ppm)) std::cout << "[soft] wrote " << ppm << "\n";
+        else std::cerr << "Cannot write " << ppm << "\n";
+    }
+    return 0;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
 //  Main
 // ─────────────────────────────────────────────────────────────────────────────
-int main()
+int main(int argc, char** argv)
 {
+    int gridSize = 10, waveSize = 256, lodBudget = 0, benchFrames = 0;
+    bool benchWaveOnly = false, benchTrigOnly = false, benchAnimOnly = false, benchGridOnly = false, softOnly = false, softCompare = false;
+    std::string ppmPath, recordPath, replayPath, benchJson;
+    bool replayFast = false;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--grid" && i + 1 < argc) gridSize = std::max(2, atoi(argv[++i]));
+        else if (a == "--lod") useLod = true;
+        else if (a == "--lod-budget" && i + 1 < argc) lodBudget = std::max(0, atoi(argv[++i]));
+        else if (a == "--wave") useWave = true;
+        else if (a == "--wave-size" && i + 1 < argc) waveSize = std::max(8, atoi(argv[++i]));
+        else if (a == "--bench-wave") benchWaveOnly = true;
+        else if (a == "--bench-trig") benchTrigOnly = true;
+        else if (a == "--bench-anim") benchAnimOnly = true;
+        else if (a == "--bench-grid") benchGridOnly = true;
+        else if (a == "--soft") softOnly = true;
+        else if (a == "--no-indirect") useIndirect = false;
+        else if (a == "--no-cull") useCull = false;
+        else if (a == "--no-phasor") usePhasor = false;
+        else if (a == "--no-pin") usePin = false;
+        else if (a == "--mesh" && i + 1 < argc) meshPath = argv[++i];
+        else if (a == "--no-meshlets") useMeshlets = false;
+        else if (a == "--anim-exec" && i + 1 < argc) {
+            if (!parseLoopExec(argv[++i], animExec)) std::cerr << "Unknown --anim-exec " << argv[i] << "\n";
+        }
+        else if (a == "--size" && i + 1 < argc) {
+            int w = 0, h = 0;
+            if (sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w >= 16 && h >= 16) { scrW = w; scrH = h; }
+            else std::cerr << "Bad --size " << argv[i] << ", expected WxH\n";
+        }
+        else if (a == "--lights" && i + 1 < argc)
+            lightCount = std::clamp(atoi(argv[++i]), 1, (int)SceneDesc::MAX_POINT_LIGHTS);
+        else if (a == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if ((a == "--replay" || a == "--replay-fast") && i + 1 < argc) {
+            replayPath = argv[++i];
+            replayFast = a == "--replay-fast";
+        }
+        else if (a == "--soft-compare") softCompare = true;
+        else if (a == "--ppm" && i + 1 < argc) ppmPath = argv[++i];
+        else if (a == "--bench" && i + 1 < argc) benchFrames = std::max(60, atoi(argv[++i]));
+        else if (a == "--bench-json" && i + 1 < argc) benchJson = argv[++i];
+        else if (a == "--lighting-cache") useCache = true;
+        else if (a == "--aa" && i + 1 < argc) {
+            if (!parseAa(argv[++i], aaMode)) std::cerr << "Unknown --aa " << argv[i] << "\n";
+        }
+        else if (a == "--lighting-res" && i + 1 < argc) {
+            int n = atoi(argv[++i]);
+            lightingScale = n >= 4 ? 4 : n >= 2 ? 2 : 1;
+        }
+        else std::cerr << "Unknown option " << a << "\n";
+    }
+    cpuTopo = CpuTopology::detect();
+    if (benchWaveOnly) return benchWave(waveSize);
+    if (benchTrigOnly) return benchTrig(gridSize);
+    if (benchGridOnly) return benchGrid(gridSize);
+    if (!loopExecAvailable(animExec)) {
+        std::cerr << "--anim-exec " << loopExecName(animExec) << " is not compiled in, using the worker pool\n";
+        animExec = LoopExec::Pool;
+    }
+    if (benchAnimOnly) return benchAnim(gridSize);
+    if (softOnly) return benchSoftware(gridSize, benchFrames ? benchFrames : 120, useLod, ppmPath);
+
+    if (!replayPath.empty()) {
+        if (!inputReplay.open(replayPath, gridSize)) { std::cerr << "Cannot read session " << replayPath << "\n"; return -1; }
+        if (benchFrames) std::cerr << "--replay drives the camera: ignoring --bench\n";
+        benchFrames = 0;
+    }
+    if (!recordPath.empty() && !inputLog.open(recordPath, gridSize)) {
+        std::cerr << "Cannot write session " << recordPath << "\n"; return -1;
+    }
+
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
-    GLFWwindow* win = glfwCreateWindow(SCR_W, SCR_H, "Kinetic Sculpture", nullptr, nullptr);
+    if (benchFrames) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // Newest context first: multi-draw indirect needs 4.3 (and shader draw
+    // parameters), direct state access 4.5; everything else runs on 3.3
+    const int GL_VERSIONS[][2] = { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } };
+    GLFWwindow* win = nullptr;
+    for (const auto& v : GL_VERSIONS) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, v[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, v[1]);
+        if ((win = glfwCreateWindow(scrW, scrH, "Kinetic Sculpture", nullptr, nullptr))) break;
+    }
     if (!win) { glfwTerminate(); return -1; }
     glfwMakeContextCurrent(win);
     glfwSetFramebufferSizeCallback(win, framebuffer_size_callback);
-    glfwSetCursorPosCallback(win, mouse_callback);
-    glfwSetScrollCallback(win, scroll_callback);
-    glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    glfwSetWindowRefreshCallback(win, window_refresh_callback);
+    if (!inputReplay.active()) {     // a replay takes its input from the log only
+        glfwSetCursorPosCallback(win, mouse_callback);
+        glfwSetScrollCallback(win, scroll_callback);
+        glfwSetInputMode(win, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -294,198 +1144,508 @@ int main()
     std::cout << "OpenGL: " << glGetString(GL_VERSION) << "\n";
 
     glEnable(GL_DEPTH_TEST);
+    if (benchFrames || replayFast) glfwSwapInterval(0);
 
-    // Build programs
+    // Build programs: the plain pair the first frame draws with now, the
+    // other variants streamed in by the loader after the scene is set up
     GLuint prog = makeProgram(VERT_SRC, FRAG_SRC);
     GLuint lightProg = makeProgram(LIGHT_VERT, LIGHT_FRAG);
-
-    // ── Cube: pos(3) + normal(3), stride = 6 floats ───────────────────────────
-    float verts[] = {
-        // Back
-        -0.5f,-0.5f,-0.5f,  0, 0,-1,
-         0.5f, 0.5f,-0.5f,  0, 0,-1,
-         0.5f,-0.5f,-0.5f,  0, 0,-1,
-         0.5f, 0.5f,-0.5f,  0, 0,-1,
-        -0.5f,-0.5f,-0.5f,  0, 0,-1,
-        -0.5f, 0.5f,-0.5f,  0, 0,-1,
-        // Front
-        -0.5f,-0.5f, 0.5f,  0, 0, 1,
-         0.5f,-0.5f, 0.5f,  0, 0, 1,
-         0.5f, 0.5f, 0.5f,  0, 0, 1,
-         0.5f, 0.5f, 0.5f,  0, 0, 1,
-        -0.5f, 0.5f, 0.5f,  0, 0, 1,
-        -0.5f,-0.5f, 0.5f,  0, 0, 1,
-        // Left
-        -0.5f, 0.5f, 0.5f, -1, 0, 0,
-        -0.5f, 0.5f,-0.5f, -1, 0, 0,
-        -0.5f,-0.5f,-0.5f, -1, 0, 0,
-        -0.5f,-0.5f,-0.5f, -1, 0, 0,
-        -0.5f,-0.5f, 0.5f, -1, 0, 0,
-        -0.5f, 0.5f, 0.5f, -1, 0, 0,
-        // Right
-         0.5f, 0.5f, 0.5f,  1, 0, 0,
-         0.5f,-0.5f,-0.5f,  1, 0, 0,
-         0.5f, 0.5f,-0.5f,  1, 0, 0,
-         0.5f,-0.5f,-0.5f,  1, 0, 0,
-         0.5f, 0.5f, 0.5f,  1, 0, 0,
-         0.5f,-0.5f, 0.5f,  1, 0, 0,
-         // Bottom
-         -0.5f,-0.5f,-0.5f,  0,-1, 0,
-          0.5f,-0.5f,-0.5f,  0,-1, 0,
-          0.5f,-0.5f, 0.5f,  0,-1, 0,
-          0.5f,-0.5f, 0.5f,  0,-1, 0,
-         -0.5f,-0.5f, 0.5f,  0,-1, 0,
-         -0.5f,-0.5f,-0.5f,  0,-1, 0,
-         // Top
-         -0.5f, 0.5f,-0.5f,  0, 1, 0,
-          0.5f, 0.5f, 0.5f,  0, 1, 0,
-          0.5f, 0.5f,-0.5f,  0, 1, 0,
-          0.5f, 0.5f, 0.5f,  0, 1, 0,
-         -0.5f, 0.5f,-0.5f,  0, 1, 0,
-         -0.5f, 0.5f, 0.5f,  0, 1, 0,
+    GLuint progMV = 0, progCached = 0, progPrepass = 0, progLowRes = 0, lightProgMV = 0, copyProg = 0, progIndirect = 0;
+    bool wantIndirect = useIndirect && GlBackend::indirectSupported();
+    std::cout << "Draw path: " << (wantIndirect ? "multi-draw indirect" : "per-run instanced")
+              << (hasDsa() ? ", direct state access" : "") << (useCull ? "" : ", no culling") << "\n";
+
+    // ── Sculpture: grid layout, animation LOD and instance positions ─────────
+    const int   GRID = gridSize;
+    SculptureGrid sculpt(GRID, SPACING);
+    WorkerPool pool(poolCpus());
+    logPool(pool);
+    AnimLod lod(sculpt, pool);
+    lod.budget = lodBudget;
+    PhasorAnim phasor(sculpt);
+    CubeWaves waves(sculpt);
+
+    std::vector<glm::vec2> base(sculpt.count());
+    for (int i = 0; i < sculpt.count(); i++) base[i] = { sculpt.gx[i], sculpt.gz[i] };
+
+    // ── Scene: light rig, material and the instance arrays ────────────────────
+    SceneDesc scene = makeSculptureScene(lightCount);
+    scene.count = sculpt.count();
+    scene.base = base.data();
+    scene.states = lod.states.data();
+
+    GlBackend gl;
+    gl.init(scene, { prog }, { lightProg });
+
+    // Until a variant arrives, the modes that need it draw plain; headless
+    // runs wait for all of them so timings and images do not depend on it
+    AsyncLoader loader;
+    auto lit = [&](GLuint& out) { return [&, o = &out](GLuint p) { *o = p; gl.addPrograms(scene, { p }, {}); }; };
+    auto marker = [&](GLuint& out) { return [&, o = &out](GLuint p) { *o = p; gl.addPrograms(scene, {}, { p }); }; };
+    loader.spawn(loadProgram(loader, VERT_SRC, FRAG_SRC, "#define MOTION_VECTORS\n", lit(progMV)));
+    loader.spawn(loadProgram(loader, VERT_SRC, FRAG_SRC, "#define MOTION_VECTORS\n#define TEMPORAL_CACHE\n", lit(progCached)));
+    loader.spawn(loadProgram(loader, VERT_SRC, FRAG_SRC, "#define GBUFFER\n", lit(progPrepass)));
+    loader.spawn(loadProgram(loader, VERT_SRC, FRAG_SRC, "#define LOW_RES_LIGHTING\n", lit(progLowRes)));
+    loader.spawn(loadProgram(loader, LIGHT_VERT, LIGHT_FRAG, "#define MOTION_VECTORS\n", marker(lightProgMV)));
+    loader.spawn(loadProgram(loader, FULLSCREEN_VERT, COPY_FRAG, "", [&](GLuint p) { copyProg = p; }));
+    // Meshlet culling needs both the mesh and the multi-draw program, which
+    // arrive in either order
+    auto meshletCull = [&] {
+        if (!useMeshlets || !gl.indirect() || !gl.meshletsWorthCulling() || gl.meshletCulling()) return;
+        gl.initMeshletCull(makeComputeProgram(MESHLET_CULL_COMP));
+        std::cout << "Meshlet culling on the GPU\n";
     };
-
-    GLuint VBO, cubeVAO, lightVAO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_STATIC_DRAW);
-
-    // Sculpture cubes
-    glGenVertexArrays(1, &cubeVAO);
-    glBindVertexArray(cubeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    // Light markers
-    glGenVertexArrays(1, &lightVAO);
-    glBindVertexArray(lightVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // ── Point light config ────────────────────────────────────────────────────
-    const float OR[4] = { 8,11, 9, 6.5f };
-    const float OY[4] = { 3, 1.5f, 5, 2.5f };
-    const float SP[4] = { 0.7f,-0.5f,1.1f,-0.9f };
-    glm::vec3 PC[4] = { {1,.25f,.25f},{.25f,1,.25f},{.25f,.25f,1},{1,.8f,.2f} };
-
-    const int   GRID = 10;
-    const float SPACING = 2.2f;
+    if (wantIndirect)
+        loader.spawn(loadProgram(loader, INDIRECT_VERT, FRAG_SRC, "#define INDIRECT\n", [&](GLuint p) {
+            gl.addPrograms(scene, { p }, {});
+            gl.initIndirect(p);
+            progIndirect = p;
+            meshletCull();
+        }));
+    std::vector<float> meshCorners;     // for the software backend
+    if (!meshPath.empty())
+        loader.spawn(loadMesh(loader, [&](const MappedMesh& m, std::vector<float>& corners) {
+            gl.setMesh(m);
+            meshCorners = std::move(corners);
+            meshletCull();
+        }));
+    if (benchFrames || inputReplay.active()) loader.wait();
+    auto loadStart = std::chrono::steady_clock::now();
+    int  loadFrames = 0;
+    SceneRecorder recorder(sculpt, pool);
+    recorder.cull = useCull;
+
+    // CPU heightfield, created on first use
+    const float WAVE_GAIN = 2.5f;
+    std::unique_ptr<WaveSolver> wave;
+    std::mt19937 rng(1234);
+
+    // ── Offscreen targets ─────────────────────────────────────────────────────
+    const glm::vec3 CLEAR = scene.clear;
+    GLuint emptyVAO;
+    glGenVertexArrays(1, &emptyVAO);
+    TemporalCache cache;
+    cache.init(scrW, scrH);
+    Taa taa;
+    taa.init(scrW, scrH);
+    MsaaTarget msaa;                // created for the selected sample count
+    ReducedLighting reduced;        // created for the selected scale
+    GpuTimer sceneTimer;
+    sceneTimer.init();
+
+    // Benchmark reference: same frame with full shading, for quality numbers.
+    // Anti-aliased runs are compared against the highest MSAA level instead.
+    GLuint refColour = 0, refDepth = 0, refFBO = 0;
+    MsaaTarget refMsaa;
+    if (benchFrames) {
+        refColour = makeTexture(scrW, scrH, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        refDepth = makeTexture(scrW, scrH, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+        refFBO = makeFramebuffer({ refColour }, refDepth);
+        if (aaMode != AaMode::None) refMsaa.init(scrW, scrH, 16);
+    }
+    int    benchFrame = 0, cpuFrames = 0, qualitySamples = 0, softSamples = 0;
+    double cpuMs = 0, animSum = 0, psnrSum = 0, psnrMin = 99, softMs = 0, softSum = 0, softMin = 99;
+    bool   refCoarse = false;       // the driver's MSAA reference is no finer than the tested mode
+    std::vector<double> frameMs;    // timed frames, for --bench-json
+
+    // Software backend, rendered alongside on sample frames for comparison
+    std::unique_ptr<SoftRasterizer> soft;
+    if (benchFrames && softCompare)
+        soft = std::make_unique<SoftRasterizer>(scrW, scrH, pool);
+    if (soft && !meshCorners.empty()) soft->setMesh(meshCorners);
+
+    float lastReport = 0;
+    int   framesDrawn = 0, framesIdle = 0;
+    int   sessionDrawn = 0, sessionIdle = 0;
+    std::vector<InputEvent> replayEvents;
+    auto  sessionStart = std::chrono::steady_clock::now();
+
+    // ── Dirty tracking: what the last presented frame was built from ────────
+    struct Seen {
+        glm::vec3 pos, front;
+        float zoom = -1;
+        bool  wave = false, lod = false, anim = false, cache = false;
+        AaMode aa = AaMode::None;
+        int   scale = 1;
+    } seen;
 
     // ── Render loop ───────────────────────────────────────────────────────────
     while (!glfwWindowShouldClose(win))
     {
         float now = (float)glfwGetTime();
         dt = now - lastFrame; lastFrame = now;
-        if (!paused) animTime += dt;
-
+        if (inputReplay.active()) {
+            if (!inputReplay.next(replayEvents, dt, replayKeys, !replayFast)) break;
+            for (const InputEvent& e : replayEvents) {
+                if (e.tag == InputEvent::Cursor) mouse_callback(win, e.a, e.b);
+                else scroll_callback(win, 0, e.a);
+            }
+        }
+        if (inputLog.active()) inputLog.frame(dt, heldKeys(win));
         processInput(win);
+        applyCommands(win);
+        if (loader.pending()) {
+            loader.pump(2.0);
+            loadFrames++;
+            if (!loader.pending())
+                std::cout << "[load] shader variants" << (meshPath.empty() ? "" : " and mesh") << " streamed in over " << loadFrames << " frames, "
+                          << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << " ms\n";
+        }
+
+        // Benchmark: fixed step and a scripted orbit around the sculpture
+        if (benchFrames) {
+            dt = 1.f / 60.f;
+            benchCamera(benchFrame, GRID);
+        }
+        auto frameStart = std::chrono::steady_clock::now();
 
-        glClearColor(0.04f, 0.04f, 0.08f, 1);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        float animStep = paused ? 0.f : dt;
+        animTime += animStep;
 
-        glm::mat4 proj = glm::perspective(glm::radians(cam.zoom),
-            (float)SCR_W / SCR_H, 0.1f, 120.f);
+        if (useWave && !wave) {
+            wave = std::make_unique<WaveSolver>(waveSize, pool);
+        }
+        bool waveChanged = false;
+        if (wave) {
+            if (waveDrop) {
+                std::uniform_real_distribution<float> u(0.1f, 0.9f);
+                wave->drop(u(rng), u(rng), 0.03f, 1.5f);
+                waveChanged = useWave;
+            }
+            if (useWave && !paused) wave->advance(dt);
+        }
+        waveDrop = false;
+
+        bool animDirty = animStep > 0 || waveChanged || !seen.anim
+            || useWave != seen.wave || useLod != seen.lod;
+        bool camDirty = cam.pos != seen.pos || cam.front != seen.front || cam.zoom != seen.zoom;
+        // MSAA renders the plain shader; the cache and TAA share the
+        // motion-vector target. Reduced-resolution lighting replaces all three.
+        // A mode whose programs are still streaming in draws plain meanwhile.
+        bool motionReady = progMV && progCached && lightProgMV;
+        int  scale = progPrepass && progLowRes && copyProg ? lightingScale : 1;
+        AaMode aa = scale > 1 || !copyProg || (aaMode == AaMode::Taa && !motionReady) ? AaMode::None : aaMode;
+        bool useTaa = aa == AaMode::Taa;
+        int  samples = aa == AaMode::Msaa4 ? 4 : aa == AaMode::Msaa8 ? 8 : 0;
+        bool cached = useCache && !samples && scale == 1 && motionReady && copyProg;
+        bool motion = cached || useTaa;
+        if (cached != seen.cache) { cache.invalidate(); viewportDirty = true; }
+        if (aa != seen.aa) {
+            if (samples && (!msaa.ready() || msaa.requested() != samples)) {
+                msaa.destroy();
+                msaa.init(scrW, scrH, samples);
+            }
+            taa.invalidate();
+            viewportDirty = true;
+        }
+        if (scale != seen.scale) {
+            if (scale > 1 && (!reduced.ready() || reduced.scale() != scale)) {
+                reduced.destroy();
+                reduced.init(scrW, scrH, scale);
+            }
+            viewportDirty = true;
+        }
+
+        if (now - lastReport > 2.f && !benchFrames) {
+            if (useLod)
+                std::cout << "[lod] " << GRID << "x" << GRID << " cubes: saved "
+                          << lod.savedPercent() << "% of cube evaluations\n";
+            if (paused)
+                std::cout << "[idle] " << framesIdle << " of " << framesDrawn + framesIdle
+                          << " frames skipped\n";
+            if (cached || aa != AaMode::None || scale > 1)
+                std::cout << "[gpu] " << (cached ? "cache, " : "") << "aa " << aaName(aa)
+                          << ", lighting 1/" << scale << " res: scene pass " << sceneTimer.meanMs() << " ms\n";
+            if (framesDrawn && sculpt.regions() > 1)
+                std::cout << "[draw] " << recorder.visibleRegions << "/" << sculpt.regions() << " regions in view, "
+                          << gl.totals().draws / framesDrawn << " draws, "
+                          << gl.totals().stateChanges / framesDrawn << " state changes, "
+                          << gl.totals().redundantBinds / framesDrawn << " redundant binds skipped/frame\n";
+            gl.resetStats();
+            lod.resetStats();
+            sceneTimer.reset();
+            framesDrawn = framesIdle = 0;
+            lastReport = now;
+        }
+
+        // Nothing moved: keep the last frame on screen and sleep until input
+        if (!animDirty && !camDirty && !viewportDirty) {
+            framesIdle++;
+            sessionIdle++;
+            if (inputReplay.active()) glfwPollEvents();
+            else glfwWaitEventsTimeout(0.1);
+            lastFrame = (float)glfwGetTime();
+            continue;
+        }
+        framesDrawn++;
+        sessionDrawn++;
+        viewportDirty = false;
+
+        glm::mat4 proj = sceneProjection(cam.zoom, GRID);
         glm::mat4 view = cam.view();
+        setCamera(scene, view, proj, cam.pos, cam.front);
+        scene.animTime = animTime;
+
+        // TAA: shift the whole frame by a sub-pixel offset, which changes
+        // the projection every frame
+        glm::mat4 drawProj = proj;
+        if (useTaa) {
+            glm::vec2 j = taa.jitter();
+            drawProj[2][0] += j.x;
+            drawProj[2][1] += j.y;
+        }
+        bool projDirty = camDirty || useTaa || seen.aa == AaMode::Taa;
+
+        // ── Uniforms and the frame's command list ─────────────────────────
+        if (animDirty) animateLights(scene, animTime);
+        gl.updateUniforms(scene, drawProj, projDirty, animDirty);
+        const CommandList& cmds = recorder.record(scene);
+
+        // ── Cube states ────────────────────────────────────────────────────
+        int    curLo = 0, curHi = 0;
+        double animMs = 0;
+        if (animDirty) {
+            auto animStart = std::chrono::steady_clock::now();
+            auto waveHeight = [&](int i) {
+                return WAVE_GAIN * wave->sample((float)sculpt.col[i] / (GRID - 1), (float)sculpt.row[i] / (GRID - 1));
+            };
+            if (!useLod) {
+                // Every cube at animTime: the phasors are rotated there once
+                // for all of them, and each cube is independent of the rest
+                bool phased = usePhasor;
+                if (phased) phasor.advance(animTime);
+                else { waves.frame(animTime); waves.prepare(); }
+                auto cube = [&](int i) {
+                    CubeState c = phased ? phasor.cube(i) : waves.at(i);
+                    if (useWave) c.gy = waveHeight(i);
+                    return c;
+                };
+                lod.updateAll(cube, animTime, animStep, animExec, pool);
+            }
+            else {
+                waves.frame(animTime);
+                auto eval = [&](int lo, int hi, float t, CubeState* out) {
+                    waves.eval(lo, hi, t, out);
+                    if (useWave)
+                        for (int i = lo; i < hi; i++) out[i - lo].gy = waveHeight(i);
+                };
+                lod.update(eval, animTime, animStep, true, cam.pos, cam.front, cam.zoom, scrH);
+            }
+            curLo = lod.dirtyLo; curHi = lod.dirtyHi;
+            animMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - animStart).count();
+        }
 
-        // Point light positions
-        glm::vec3 ptPos[4];
-        for (int i = 0; i < 4; i++) {
-            float a = SP[i] * animTime + i * glm::two_pi<float>() / 4.f;
-            ptPos[i] = { OR[i] * cosf(a),
-                        OY[i] + 1.5f * sinf(animTime * .7f + i),
-                        OR[i] * sinf(a) };
-        }
-
-        // ── Lighting pass ──────────────────────────────────────────────────
-        glUseProgram(prog);
-        setMat4(prog, "projection", proj);
-        setMat4(prog, "view", view);
-        setVec3(prog, "viewPos", cam.pos);
-
-        // Material
-        setVec3(prog, "matDiffuse", { 0.2f,0.45f,0.7f });
-        setVec3(prog, "matSpecular", { 0.8f,0.85f,0.9f });
-        setFloat(prog, "matShininess", 96.f);
-
-        // Directional
-        setVec3(prog, "dirLight.direction", { -0.3f,-1,-0.4f });
-        setVec3(prog, "dirLight.ambient", { 0.04f,0.04f,0.06f });
-        setVec3(prog, "dirLight.diffuse", { 0.2f,0.2f,0.3f });
-        setVec3(prog, "dirLight.specular", { 0.5f,0.5f,0.5f });
-
-        // Point lights
-        for (int i = 0; i < 4; i++) {
-            std::string b = "pointLights[" + std::to_string(i) + "].";
-            setVec3(prog, (b + "position").c_str(), ptPos[i]);
-            setFloat(prog, (b + "constant").c_str(), 1.f);
-            setFloat(prog, (b + "linear").c_str(), 0.07f);
-            setFloat(prog, (b + "quadratic").c_str(), 0.017f);
-            setVec3(prog, (b + "ambient").c_str(), PC[i] * 0.05f);
-            setVec3(prog, (b + "diffuse").c_str(), PC[i]);
-            setVec3(prog, (b + "specular").c_str(), PC[i]);
-        }
-
-        // Spot
-        setVec3(prog, "spotLight.position", cam.pos);
-        setVec3(prog, "spotLight.direction", cam.front);
-        setFloat(prog, "spotLight.cutOff", cosf(glm::radians(12.5f)));
-        setFloat(prog, "spotLight.outerCutOff", cosf(glm::radians(17.5f)));
-        setFloat(prog, "spotLight.constant", 1.f);
-        setFloat(prog, "spotLight.linear", 0.05f);
-        setFloat(prog, "spotLight.quadratic", 0.012f);
-        setVec3(prog, "spotLight.ambient", { 0,0,0 });
-        setVec3(prog, "spotLight.diffuse", { 1,1,1 });
-        setVec3(prog, "spotLight.specular", { 1,1,1 });
-
-        // ── Draw sculpture ─────────────────────────────────────────────────
-        glBindVertexArray(cubeVAO);
-        float off = (GRID - 1) * SPACING * 0.5f;
-
-        for (int row = 0; row < GRID; row++)
-            for (int col = 0; col < GRID; col++)
-            {
-                float gx = col * SPACING - off;
-                float gz = row * SPACING - off;
-                float d = sqrtf(gx * gx + gz * gz);
-
-                float gy = 2.0f * sinf(d * 0.55f - animTime * 2.f)
-                    + 0.8f * sinf(gx * 0.5f + animTime * 1.3f)
-                    + 0.8f * cosf(gz * 0.5f - animTime * 1.1f);
-
-                float spin = animTime * 50.f + d * 12.f;
-                float s = 0.88f + 0.12f * sinf(animTime * 3.f + d);
-
-                glm::mat4 model(1.f);
-                model = glm::translate(model, { gx,gy,gz });
-                model = glm::rotate(model, glm::radians(spin), { 0,1,0 });
-                model = glm::scale(model, { s,s,s });
-                setMat4(prog, "model", model);
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+        gl.uploadStates(scene, curLo, curHi);
+
+        // ── Draw ───────────────────────────────────────────────────────────
+        auto drawScene = [&](GLuint lit, GLuint marker, bool motion) {
+            gl.use(lit, marker, motion);
+            gl.submit(scene, cmds);
+        };
+        // Full shading without motion vectors, in one multi-draw when possible
+        auto drawPlain = [&]() {
+            if (progIndirect) drawScene(progIndirect, progIndirect, false);
+            else drawScene(prog, lightProg, false);
+        };
+
+        int fbW, fbH;
+        glfwGetFramebufferSize(win, &fbW, &fbH);
+
+        // Scene pass into whichever target the mode needs; outTex/outFbo
+        // is the finished image when it did not go straight to the window
+        GLuint outTex = 0, outFbo = 0;
+        sceneTimer.begin();
+        if (scale > 1) {
+            reduced.beginPrepass();
+            drawScene(progPrepass, 0, false);
+            reduced.beginLighting();
+            drawScene(progLowRes, 0, false);
+            reduced.upsample(CLEAR, emptyVAO);
+            drawScene(0, lightProg, false);
+            outTex = reduced.output(); outFbo = reduced.outputFbo();
+        }
+        else if (samples) {
+            msaa.begin(CLEAR);
+            drawPlain();
+            msaa.resolve();
+            outTex = msaa.output(); outFbo = msaa.outputFbo();
+        }
+        else if (motion) {
+            GLuint lit = cached ? progCached : progMV;
+            glViewport(0, 0, scrW, scrH);
+            cache.begin(CLEAR);
+            glState().useProgram(lit);
+            if (cached) cache.bind(lit);
+            drawScene(lit, lightProgMV, true);
+            cache.end();
+            outTex = cache.output(); outFbo = cache.outputFbo();
+            if (useTaa) {
+                taa.resolve(cache.output(), cache.velocity, emptyVAO);
+                outTex = taa.output(); outFbo = taa.outputFbo();
+            }
+        }
+        else {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, fbW, fbH);
+            glClearColor(CLEAR.x, CLEAR.y, CLEAR.z, 1);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            drawPlain();
+        }
+        sceneTimer.end();
+        GlBackend::Stats sceneStats = gl.frameStats();
+
+        // Benchmark quality sample against a reference render of the same
+        // frame: full shading, or the highest MSAA level when anti-aliasing
+        bool sample = benchFrames && outFbo && benchFrame % 30 == 29;
+        bool check = soft && benchFrame % 30 == 29;
+        if ((sample || check) && useTaa)    // reset every frame while jittering
+            for (GLuint p : { prog, lightProg, progIndirect }) {
+                if (!p) continue;
+                glState().useProgram(p);
+                setMat4(p, "projection", proj);
             }
+        auto drawReference = [&]() {
+            glBindFramebuffer(GL_FRAMEBUFFER, refFBO);
+            glViewport(0, 0, scrW, scrH);
+            glClearColor(CLEAR.x, CLEAR.y, CLEAR.z, 1);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            drawPlain();
+        };
+        // GL_MAX_SAMPLES may clamp the reference to the tested sample count
+        // (or to none under TAA), and a mode compared with itself says nothing
+        bool refFine = aa == AaMode::None || refMsaa.samples() > (samples ? msaa.samples() : 1);
+        if (sample && !refFine) refCoarse = true;
+        if (sample && refFine) {
+            GLuint ref = refFBO;
+            if (aa != AaMode::None) {
+                refMsaa.begin(CLEAR);
+                drawPlain();
+                refMsaa.resolve();
+                ref = refMsaa.outputFbo();
+            }
+            else
+                drawReference();
+            double q = psnr(readColour(ref, scrW, scrH), readColour(outFbo, scrW, scrH));
+            psnrSum += q; psnrMin = std::min(psnrMin, q); qualitySamples++;
+        }
+
+        // Software backend against GL full shading of the same scene
+        if (check) {
+            drawReference();
+            auto t0 = std::chrono::steady_clock::now();
+            soft->submit(scene, cmds);
+            softMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            double q = psnr(readColour(refFBO, scrW, scrH), soft->colour());
+            softSum += q; softMin = std::min(softMin, q); softSamples++;
+        }
 
-        // ── Draw light markers ─────────────────────────────────────────────
-        glUseProgram(lightProg);
-        setMat4(lightProg, "projection", proj);
-        setMat4(lightProg, "view", view);
-        glBindVertexArray(lightVAO);
-        for (int i = 0; i < 4; i++) {
-            setVec3(lightProg, "lightColor", PC[i]);
-            glm::mat4 m = glm::scale(glm::translate(glm::mat4(1), ptPos[i]), { .25f,.25f,.25f });
-            setMat4(lightProg, "model", m);
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+        if (outTex) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, fbW, fbH);
+            glDisable(GL_DEPTH_TEST);
+            glState().useProgram(copyProg);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, outTex);
+            setInt(copyProg, "src", 0);
+            drawFullscreen(emptyVAO);
+            glEnable(GL_DEPTH_TEST);
         }
 
+        seen = { cam.pos, cam.front, cam.zoom, useWave, useLod, true, cached, aa, scale };
+        gl.endFrame(scene);
+
         glfwSwapBuffers(win);
         glfwPollEvents();
+
+        // ── Benchmark bookkeeping ──────────────────────────────────────────
+        if (benchFrames) {
+            benchFrame++;
+            if (benchFrame == 30) sceneTimer.reset();       // warm-up
+            if (benchFrame > 30 && !sample && !check) {
+                frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+                cpuMs += frameMs.back();
+                animSum += animMs;
+                cpuFrames++;
+            }
+            if (benchFrame >= benchFrames) {
+                std::cout << "[bench] " << benchFrame << " frames, " << GRID << "x" << GRID << " cubes, "
+                          << lightCount << " lights, " << scrW << "x" << scrH
+                          << (cached ? ", lighting cache" : "") << ", aa " << aaName(aa);
+                if (scale > 1) std::cout << ", lighting 1/" << scale << " res";
+                if (samples) std::cout << " (" << msaa.samples() << " samples)";
+                std::cout << ", " << recorder.visibleRegions << "/" << sculpt.regions() << " regions in view, "
+                          << cmds.size() << " commands, " << sceneStats.draws << " draws, "
+                          << sceneStats.stateChanges << " state changes (" << sceneStats.redundantBinds
+                          << " redundant binds skipped)";
+                if (gl.meshletCulling()) {
+                    GlBackend::MeshletStats ms = gl.meshletStats();
+                    std::cout << ", meshlets " << ms.drawn << "/" << ms.tested << " drawn (" << ms.outside << " outside the frustum, "
+                              << ms.backFacing << " facing away)";
+                }
+                std::cout << ": cpu " << cpuMs / std::max(cpuFrames, 1) << " ms/frame (cube states "
+                          << animSum / std::max(cpuFrames, 1) << " ms, " << (useLod ? "lod" : loopExecName(animExec))
+                          << "), gpu scene " << sceneTimer.meanMs() << " ms";
+                if (qualitySamples)
+                    std::cout << ", PSNR " << psnrSum / qualitySamples << " dB (min " << psnrMin << ")";
+                else if (refCoarse)
+                    std::cout << ", no PSNR (the reference MSAA has only " << refMsaa.samples() << " samples)";
+                if (softSamples)
+                    std::cout << ", software " << softMs / softSamples << " ms/frame, PSNR vs GL "
+                              << softSum / softSamples << " dB (min " << softMin << ")";
+                std::cout << "\n";
+
+                // Same numbers for scripts
+                if (!benchJson.empty()) {
+                    std::ofstream js(benchJson);
+                    js << "{\"frames\": " << benchFrame << ", \"grid\": " << GRID << ", \"lights\": " << lightCount
+                       << ", \"width\": " << scrW << ", \"height\": " << scrH
+                       << ", \"cull\": " << (useCull ? "true" : "false")
+                       << ", \"phasor\": " << (usePhasor && !useLod ? "true" : "false")
+                       << ", \"aa\": \"" << aaName(aa) << "\", \"lighting_scale\": " << scale
+                       << ", \"lighting_cache\": " << (cached ? "true" : "false")
+                       << ", \"indirect\": " << (progIndirect ? "true" : "false")
+                       << ", \"draws\": " << sceneStats.draws << ", \"state_changes\": " << sceneStats.stateChanges
+                       << ", \"cpu_ms\": " << cpuMs / std::max(cpuFrames, 1) << ", \"gpu_ms\": " << sceneTimer.meanMs()
+                       << ", \"anim_ms\": " << animSum / std::max(cpuFrames, 1)
+                       << ", \"anim_exec\": \"" << (useLod ? "lod" : loopExecName(animExec)) << "\"";
+                    if (qualitySamples) js << ", \"psnr\": " << psnrSum / qualitySamples;
+                    else if (refCoarse) js << ", \"psnr\": null, \"reference_samples\": " << refMsaa.samples();
+                    js << ", \"frame_ms\": [";
+                    for (size_t i = 0; i < frameMs.size(); i++) js << (i ? ", " : "") << frameMs[i];
+                    js << "]}\n";
+                    if (!js) std::cerr << "Cannot write " << benchJson << "\n";
+                }
+                break;
+            }
+        }
+    }
+
+    double sessionSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - sessionStart).count();
+    if (inputReplay.active())
+        std::cout << "[replay] " << sessionDrawn + sessionIdle << " frames (" << sessionIdle << " idle) in "
+                  << sessionSec << " s" << (replayFast ? ", as fast as possible" : ", real time") << ": "
+                  << sessionDrawn / sessionSec << " drawn frames/s, " << sessionSec * 1000.0 / std::max(sessionDrawn, 1)
+                  << " ms/frame; final camera " << cam.pos.x << " " << cam.pos.y << " " << cam.pos.z
+                  << ", anim time " << animTime << "\n";
+    if (inputLog.active()) {
+        std::cout << "[record] " << inputLog.frames() << " frames written to " << recordPath << "; final camera "
+                  << cam.pos.x << " " << cam.pos.y << " " << cam.pos.z << ", anim time " << animTime << "\n";
+        inputLog.close();
     }
 
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteVertexArrays(1, &lightVAO);
-    glDeleteBuffers(1, &VBO);
+    cache.destroy();
+    taa.destroy();
+    msaa.destroy();
+    reduced.destroy();
+    refMsaa.destroy();
+    if (refFBO) {
+        glDeleteFramebuffers(1, &refFBO);
+        glDeleteTextures(1, &refColour);
+        glDeleteTextures(1, &refDepth);
+    }
+    glDeleteVertexArrays(1, &emptyVAO);
+    loader.wait();
+    gl.destroy();
     glfwTerminate();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// The standard parallel algorithms pull in the TBB backend with libstdc++, so
+// they are opt-in: build with -DPAR_STL and link -ltbb. OpenMP is on with
+// -fopenmp.
+#ifdef PAR_STL
+#include <execution>
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Per-element loops
+//  One loop body over a contiguous array, run serially, on the worker pool,
+//  with std::for_each(par_unseq) or with OpenMP parallel for simd, so the
+//  backends can be compared on the same work. The body must only write its
+//  own element (par_unseq may also interleave iterations on one thread).
+// ─────────────────────────────────────────────────────────────────────────────
+enum class LoopExec { Serial, Pool, ParUnseq, OpenMp };
+
+inline const char* loopExecName(LoopExec e)
+{
+    switch (e) {
+    case LoopExec::Serial:   return "serial";
+    case LoopExec::Pool:     return "pool";
+    case LoopExec::ParUnseq: return "par_unseq";
+    case LoopExec::OpenMp:   return "openmp";
+    }
+    return "?";
+}
+
+inline bool loopExecAvailable(LoopExec e)
+{
+    (void)e;
+#ifndef PAR_STL
+    if (e == LoopExec::ParUnseq) return false;
+#endif
+#ifndef _OPENMP
+    if (e == LoopExec::OpenMp) return false;
+#endif
+    return true;
+}
+
+inline bool parseLoopExec(const std::string& s, LoopExec& out)
+{
+    for (LoopExec e : { LoopExec::Serial, LoopExec::Pool, LoopExec::ParUnseq, LoopExec::OpenMp })
+        if (s == loopExecName(e)) { out = e; return true; }
+    return false;
+}
+
+// fn(v[i], i) for every element; backends not compiled in run on the pool
+template <class T, class A, class F>
+void forEachElement(LoopExec e, WorkerPool& pool, std::vector<T, A>& v, F&& fn)
+{
+    int n = (int)v.size();
+    T* base = v.data();
+    switch (e) {
+    case LoopExec::Serial:
+        for (int i = 0; i < n; i++) fn(base[i], i);
+        return;
+#ifdef PAR_STL
+    case LoopExec::ParUnseq:
+        std::for_each(std::execution::par_unseq, v.begin(), v.end(), [&](T& x) { fn(x, (int)(&x - base)); });
+        return;
+#endif
+#ifdef _OPENMP
+    case LoopExec::OpenMp:
+#pragma omp parallel for simd schedule(static)
+        for (int i = 0; i < n; i++) fn(base[i], i);
+        return;
+#endif
+    default:
+        pool.parallelFor(0, n, [&](int lo, int hi, unsigned) {
+            for (int i = lo; i < hi; i++) fn(base[i], i);
+        });
+    }
+}
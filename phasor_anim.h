@@ -0,0 +1,98 @@
+#pragma once
+
+#include "fast_trig.h"
+#include "sculpture.h"
+
+#include <algorithm>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Incremental wave evaluation
+//  evalCube's radial wave and scale pulse are sin(a + w t) with a phase a
+//  that depends only on d and shared angular speeds w. Each distance class
+//  keeps them as unit phasors; moving to a new time rotates every phasor by
+//  the same per-wave angle w dt, so a frame costs a complex multiply per wave
+//  per class. The column and row waves are separable and come from per-frame
+//  tables instead, so a cube is just three table lookups.
+//  Rounding drift is bounded by re-seeding a rotating slice of classes
+//  exactly every step, so no phasor goes more than RESYNC_STEPS steps
+//  unchecked. Only valid when every cube is evaluated at the same time (no
+//  animation LOD).
+// ─────────────────────────────────────────────────────────────────────────────
+class PhasorAnim {
+public:
+    static const int RESYNC_STEPS = 256;
+    static constexpr float W[2] = { -2.f, 3.f };    // radial wave and pulse, as in evalCube
+
+    explicit PhasorAnim(const SculptureGrid& g) : g(g), waves(g), radial(g.classes()), pulse(g.classes())
+    {
+        for (int k = 0; k < 2; k++) { re[k].resize(g.classes()); im[k].resize(g.classes()); }
+    }
+
+    bool  seeded() const { return valid; }
+    float time() const { return now; }
+
+    // Exact phasors for every class at time t
+    void reset(float t)
+    {
+        now = t;
+        waves.frame(t);
+        seed(0, g.classes());
+        cursor = 0;
+        valid = true;
+    }
+
+    // Rotate every phasor from the current time to t
+    void advance(float t)
+    {
+        if (!valid) { reset(t); return; }
+        float rc[2], rs[2];
+        for (int k = 0; k < 2; k++) fast::sincos(W[k] * (t - now), rs[k], rc[k]);
+        now = t;
+        waves.frame(t);
+
+        int n = g.classes();
+        float* r0 = re[0].data(); float* r1 = re[1].data();
+        float* i0 = im[0].data(); float* i1 = im[1].data();
+        for (int k = 0; k < n; k++) {
+            float a0 = r0[k] * rc[0] - i0[k] * rs[0], b0 = r0[k] * rs[0] + i0[k] * rc[0];
+            float a1 = r1[k] * rc[1] - i1[k] * rs[1], b1 = r1[k] * rs[1] + i1[k] * rc[1];
+            r0[k] = a0; i0[k] = b0; r1[k] = a1; i1[k] = b1;
+            radial[k] = 2.0f * b0;
+            pulse[k] = 0.88f + 0.12f * b1;
+        }
+
+        int slice = (n + RESYNC_STEPS - 1) / RESYNC_STEPS;
+        int lo = cursor, hi = std::min(n, lo + slice);
+        seed(lo, hi);
+        cursor = hi < n ? hi : 0;
+    }
+
+    // State of cube i at time()
+    CubeState cube(int i) const
+    {
+        int k = g.dClass[i];
+        return { radial[k] + waves.columns()[g.col[i]] + waves.rows()[g.row[i]], now * 50.f + g.d[i] * 12.f, pulse[k] };
+    }
+
+private:
+    // Exact phasors and terms for classes [lo, hi) at now
+    void seed(int lo, int hi)
+    {
+        for (int k = lo; k < hi; k++) {
+            float d = g.classD[k];
+            fast::sincos(d * 0.55f + W[0] * now, im[0][k], re[0][k]);
+            fast::sincos(d + W[1] * now, im[1][k], re[1][k]);
+            radial[k] = 2.0f * im[0][k];
+            pulse[k] = 0.88f + 0.12f * im[1][k];
+        }
+    }
+
+    const SculptureGrid& g;
+    CubeWaves waves;                    // column and row tables at now
+    std::vector<float> re[2], im[2];    // per wave, per distance class
+    std::vector<float> radial, pulse;   // per class at now
+    float now = 0;
+    int   cursor = 0;
+    bool  valid = false;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "gl_util.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Reduced-resolution lighting
+//  A full-resolution prepass writes normals and view depth without shading;
+//  the lit pass runs at 1/scale resolution in each axis, and a joint bilateral
+//  upsample weights the four nearest low-resolution samples by bilinear
+//  footprint, depth similarity and normal agreement, so lighting does not
+//  bleed across cube silhouettes. The full-resolution depth stays attached to
+//  the output so unlit geometry (the light markers) can be drawn on top.
+// ─────────────────────────────────────────────────────────────────────────────
+static const char* UPSAMPLE_FRAG = R"GLSL(
+#version 330 core
+in vec2 uv;
+out vec4 FragColor;
+
+uniform sampler2D fullNormalDepth;  // xyz = normal, a = view depth (0 = background)
+uniform sampler2D lowColour;        // rgb = lit colour, a = view depth
+uniform sampler2D lowNormal;
+uniform vec3      clearColour;
+
+void main()
+{
+    vec4 g = texture(fullNormalDepth, uv);
+    if (g.a <= 0.0) { FragColor = vec4(clearColour, 1.0); return; }
+
+    ivec2 size = textureSize(lowColour, 0);
+    vec2  p = uv * vec2(size) - 0.5;
+    vec2  f = fract(p);
+    ivec2 b = ivec2(floor(p));
+
+    vec3  sum = vec3(0.0), fallback = vec3(0.0);
+    float wsum = 0.0, best = 1e30;
+    for (int i = 0; i < 4; i++) {
+        ivec2 o = ivec2(i & 1, i >> 1);
+        ivec2 t = clamp(b + o, ivec2(0), size - 1);
+        vec4  c = texelFetch(lowColour, t, 0);
+        vec3  n = texelFetch(lowNormal, t, 0).xyz;
+        float dz = abs(c.a - g.a) / g.a;
+        float dn = max(dot(n, g.xyz), 0.0);
+        float bw = mix(1.0 - f.x, f.x, float(o.x)) * mix(1.0 - f.y, f.y, float(o.y));
+        float w  = bw * exp(-dz * 50.0) * pow(dn, 16.0);
+        sum += c.rgb * w; wsum += w;
+
+        // No sample on the same surface: take the closest match instead
+        float miss = dz + (1.0 - dn);
+        if (c.a > 0.0 && miss < best) { best = miss; fallback = c.rgb; }
+    }
+    FragColor = vec4(wsum > 1e-4 ? sum / wsum : fallback, 1.0);
+}
+)GLSL";
+
+class ReducedLighting {
+public:
+    void init(int w, int h, int scale)
+    {
+        width = w; height = h; factor = scale;
+        lw = (w + scale - 1) / scale; lh = (h + scale - 1) / scale;
+
+        normalDepth = makeTexture(w, h, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        depth = makeTexture(w, h, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+        prepassFbo = makeFramebuffer({ normalDepth }, depth);
+
+        lowColour = makeTexture(lw, lh, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        lowNormal = makeTexture(lw, lh, GL_RGBA16F, GL_RGBA, GL_FLOAT, GL_NEAREST);
+        lowDepth = makeTexture(lw, lh, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+        lowFbo = makeFramebuffer({ lowColour, lowNormal }, lowDepth);
+
+        colour = makeTexture(w, h, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        fbo = makeFramebuffer({ colour }, depth);
+
+        prog = makeProgram(FULLSCREEN_VERT, UPSAMPLE_FRAG);
+    }
+
+    void destroy()
+    {
+        GLuint fbos[3] = { prepassFbo, lowFbo, fbo };
+        GLuint tex[6] = { normalDepth, depth, lowColour, lowNormal, lowDepth, colour };
+        glDeleteFramebuffers(3, fbos);
+        glDeleteTextures(6, tex);
+        glDeleteProgram(prog);
+        prepassFbo = lowFbo = fbo = prog = 0;
+    }
+
+    // Full-resolution normal/depth prepass target
+    void beginPrepass()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, prepassFbo);
+        glViewport(0, 0, width, height);
+        const float z[4] = {};
+        glClearBufferfv(GL_COLOR, 0, z);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    // Low-resolution lit pass target
+    void beginLighting()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, lowFbo);
+        glViewport(0, 0, lw, lh);
+        const float z[4] = {};
+        glClearBufferfv(GL_COLOR, 0, z);
+        glClearBufferfv(GL_COLOR, 1, z);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    // Resolves into the output, which stays bound with the prepass depth
+    void upsample(glm::vec3 clearColour, GLuint emptyVAO)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        glState().useProgram(prog);
+        const GLuint tex[3] = { normalDepth, lowColour, lowNormal };
+        for (int i = 0; i < 3; i++) {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, tex[i]);
+        }
+        setInt(prog, "fullNormalDepth", 0);
+        setInt(prog, "lowColour", 1);
+        setInt(prog, "lowNormal", 2);
+        setVec3(prog, "clearColour", clearColour);
+        glDisable(GL_DEPTH_TEST);
+        drawFullscreen(emptyVAO);
+        glEnable(GL_DEPTH_TEST);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    bool   ready() const { return prog != 0; }
+    int    scale() const { return factor; }
+    GLuint output() const { return colour; }
+    GLuint outputFbo() const { return fbo; }
+
+private:
+    int    width = 0, height = 0, lw = 0, lh = 0, factor = 1;
+    GLuint normalDepth = 0, depth = 0, prepassFbo = 0;
+    GLuint lowColour = 0, lowNormal = 0, lowDepth = 0, lowFbo = 0;
+    GLuint colour = 0, fbo = 0, prog = 0;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "scene.h"
+#include "sculpture.h"
+#include "worker_pool.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Draw commands
+//  Backend-neutral: a run of sculpture instances or one light marker. What
+//  they look like (programs, lights, camera) comes from the SceneDesc the
+//  list is submitted with.
+// ─────────────────────────────────────────────────────────────────────────────
+struct DrawCmd {
+    enum Kind : uint8_t { Cubes, Marker };
+    Kind kind;
+    int  first, count;      // instance range, or marker index in first
+};
+
+class CommandList {
+public:
+    void clear() { cmds.clear(); }
+
+    // Contiguous runs merge into one draw
+    void drawCubes(int first, int count)
+    {
+        if (!cmds.empty() && cmds.back().kind == DrawCmd::Cubes && cmds.back().first + cmds.back().count == first)
+            cmds.back().count += count;
+        else
+            cmds.push_back({ DrawCmd::Cubes, first, count });
+    }
+
+    void drawMarker(int i) { cmds.push_back({ DrawCmd::Marker, i, 1 }); }
+
+    void append(const CommandList& o)
+    {
+        for (const DrawCmd& c : o.cmds) {
+            if (c.kind == DrawCmd::Cubes) drawCubes(c.first, c.count);
+            else cmds.push_back(c);
+        }
+    }
+
+    const std::vector<DrawCmd>& commands() const { return cmds; }
+    size_t size() const { return cmds.size(); }
+
+private:
+    std::vector<DrawCmd> cmds;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Backend interface
+//  A backend draws a recorded list against one frame's SceneDesc; how it
+//  got its targets and per-pass setup is up to the backend.
+// ─────────────────────────────────────────────────────────────────────────────
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+    virtual void submit(const SceneDesc& s, const CommandList& cmds) = 0;
+};
+
+// Gribb/Hartmann: planes as rows of the clip matrix, normalised, inside
+// where dot(plane.xyz, p) + plane.w >= 0
+inline void frustumPlanes(const glm::mat4& m, glm::vec4 out[6])
+{
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++) row[i] = { m[0][i], m[1][i], m[2][i], m[3][i] };
+    for (int i = 0; i < 3; i++) {
+        out[i * 2] = row[3] + row[i];
+        out[i * 2 + 1] = row[3] - row[i];
+    }
+    for (int i = 0; i < 6; i++) out[i] /= glm::length(glm::vec3(out[i]));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Scene recording
+//  Workers frustum-cull the sculpture's regions (each a contiguous instance
+//  range) into lists of their own; the lists are joined in region order, so
+//  neighbouring visible regions still come out as one draw. With culling off
+//  every region is recorded, which merges to a single draw.
+// ─────────────────────────────────────────────────────────────────────────────
+class SceneRecorder {
+public:
+    int  visibleRegions = 0;
+    bool cull = true;
+
+    SceneRecorder(const SculptureGrid& g, WorkerPool& pool) : g(g), pool(pool), partial(pool.size()) {}
+
+    const CommandList& record(const SceneDesc& s)
+    {
+        glm::vec4 planes[6];
+        frustumPlanes(s.proj * s.view, planes);
+        // Heightfield ripples can lift cubes past the closed-form bound
+        float radius = g.regionRadius + 4.f;
+
+        std::vector<int> visible(pool.size(), 0);
+        pool.parallelFor(0, g.regions(), [&](int lo, int hi, unsigned w) {
+            CommandList& out = partial[w];
+            out.clear();
+            for (int r = lo; r < hi; r++) {
+                if (cull && !inside(planes, g.regionCentre[r], radius)) continue;
+                out.drawCubes(g.regionStart[r], g.regionStart[r + 1] - g.regionStart[r]);
+                visible[w]++;
+            }
+        });
+
+        list.clear();
+        visibleRegions = 0;
+        for (unsigned w = 0; w < pool.size(); w++) {
+            list.append(partial[w]);
+            visibleRegions += visible[w];
+        }
+        for (size_t i = 0; i < s.pointLights.size(); i++)
+            list.drawMarker((int)i);
+        return list;
+    }
+
+    const CommandList& commands() const { return list; }
+
+private:
+    static bool inside(const glm::vec4 planes[6], glm::vec3 c, float r)
+    {
+        for (int i = 0; i < 6; i++)
+            if (glm::dot(glm::vec3(planes[i]), c) + planes[i].w < -r) return false;
+        return true;
+    }
+
+    const SculptureGrid& g;
+    WorkerPool& pool;
+    std::vector<CommandList> partial;   // per worker
+    CommandList list;
+};
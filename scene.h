@@ -0,0 +1,176 @@
+#pragma once
+
+#include "anim_lod.h"
+#include "fast_trig.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Scene description
+//  Everything a backend needs to draw one frame of the sculpture: camera,
+//  lights and material (mirroring the shader structs), and the per-instance
+//  grid positions and LOD state pairs.
+// ─────────────────────────────────────────────────────────────────────────────
+struct DirLight {
+    glm::vec3 direction, ambient, diffuse, specular;
+};
+
+struct PointLight {
+    glm::vec3 position;
+    float     constant, linear, quadratic;
+    glm::vec3 ambient, diffuse, specular;
+};
+
+struct SpotLight {
+    glm::vec3 position, direction;
+    float     cutOff, outerCutOff;
+    float     constant, linear, quadratic;
+    glm::vec3 ambient, diffuse, specular;
+};
+
+struct Material {
+    glm::vec3 diffuse, specular;
+    float     shininess;
+};
+
+struct SceneDesc {
+    static const int MAX_POINT_LIGHTS = 256;    // the shader's light block
+
+    glm::mat4  view{ 1.f }, proj{ 1.f };
+    glm::vec3  viewPos{ 0.f };
+    glm::vec3  clear{ 0.04f, 0.04f, 0.08f };
+    Material   mat;
+    DirLight   dirLight;
+    std::vector<PointLight> pointLights;
+    SpotLight  spotLight;
+    std::vector<glm::vec3>  markerColour;   // marker cube at each point light
+    float      markerSize = 0.25f;
+
+    float animTime = 0;
+    int   count = 0;                        // instances
+    const glm::vec2*     base = nullptr;    // grid x, z
+    const InstanceState* states = nullptr;
+};
+
+// Fully saturated colour at hue h (in turns)
+inline glm::vec3 hueColour(float h)
+{
+    float x = (h - floorf(h)) * 6.f;
+    return glm::clamp(glm::vec3(fabsf(x - 3.f) - 1.f, 2.f - fabsf(x - 2.f), 2.f - fabsf(x - 4.f)), 0.f, 1.f);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  The sculpture's rig
+//  Four coloured point lights; larger rigs add lights round the hue circle
+//  and dim all of them so the total stays about the same.
+// ─────────────────────────────────────────────────────────────────────────────
+inline SceneDesc makeSculptureScene(int lights = 4)
+{
+    SceneDesc s;
+    s.mat = { { 0.2f,0.45f,0.7f }, { 0.8f,0.85f,0.9f }, 96.f };
+    s.dirLight = { { -0.3f,-1,-0.4f }, { 0.04f,0.04f,0.06f }, { 0.2f,0.2f,0.3f }, { 0.5f,0.5f,0.5f } };
+
+    lights = std::clamp(lights, 1, SceneDesc::MAX_POINT_LIGHTS);
+    const glm::vec3 PC[4] = { {1,.25f,.25f},{.25f,1,.25f},{.25f,.25f,1},{1,.8f,.2f} };
+    float k = std::min(1.f, 4.f / lights);
+    for (int i = 0; i < lights; i++) {
+        glm::vec3 c = i < 4 ? PC[i] : hueColour(i * 0.618f) * 0.75f + 0.25f;
+        s.pointLights.push_back({ {}, 1.f, 0.07f, 0.017f, c * 0.05f * k, c * k, c * k });
+        s.markerColour.push_back(c);
+    }
+
+    s.spotLight = { {}, {}, cosf(glm::radians(12.5f)), cosf(glm::radians(17.5f)),
+                    1.f, 0.05f, 0.012f, { 0,0,0 }, { 1,1,1 }, { 1,1,1 } };
+    return s;
+}
+
+// Point lights orbit the sculpture at their own radius, height and speed
+inline void animateLights(SceneDesc& s, float t)
+{
+    const float OR[4] = { 8,11, 9, 6.5f };
+    const float OY[4] = { 3, 1.5f, 5, 2.5f };
+    const float SP[4] = { 0.7f,-0.5f,1.1f,-0.9f };
+    for (size_t i = 0; i < s.pointLights.size(); i++) {
+        float r, y, sp, phase;
+        if (i < 4) { r = OR[i]; y = OY[i]; sp = SP[i]; phase = i * glm::two_pi<float>() / 4.f; }
+        else {
+            auto frac = [](float x) { return x - floorf(x); };
+            r = 5.f + 9.f * frac(i * 0.618f);
+            y = 1.f + 5.f * frac(i * 0.382f);
+            sp = (i & 1 ? -1.f : 1.f) * (0.4f + 0.8f * frac(i * 0.754f));
+            phase = i * 2.39996f;       // golden angle
+        }
+        float a = sp * t + phase, sa, ca;
+        fast::sincos(a, sa, ca);
+        s.pointLights[i].position = { r * ca, y + 1.5f * fast::sin(t * .7f + i), r * sa };
+    }
+}
+
+// Camera with the spot light as a flashlight
+inline void setCamera(SceneDesc& s, const glm::mat4& view, const glm::mat4& proj, glm::vec3 pos, glm::vec3 front)
+{
+    s.view = view;
+    s.proj = proj;
+    s.viewPos = pos;
+    s.spotLight.position = pos;
+    s.spotLight.direction = front;
+}
+
+inline glm::mat4 markerModel(glm::vec3 pos, float size)
+{
+    return glm::scale(glm::translate(glm::mat4(1), pos), glm::vec3(size));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Unit cube: pos(3) + normal(3), stride = 6 floats, 36 vertices
+// ─────────────────────────────────────────────────────────────────────────────
+static const float CUBE_VERTS[] = {
+    // Back
+    -0.5f,-0.5f,-0.5f,  0, 0,-1,
+     0.5f, 0.5f,-0.5f,  0, 0,-1,
+     0.5f,-0.5f,-0.5f,  0, 0,-1,
+     0.5f, 0.5f,-0.5f,  0, 0,-1,
+    -0.5f,-0.5f,-0.5f,  0, 0,-1,
+    -0.5f, 0.5f,-0.5f,  0, 0,-1,
+    // Front
+    -0.5f,-0.5f, 0.5f,  0, 0, 1,
+     0.5f,-0.5f, 0.5f,  0, 0, 1,
+     0.5f, 0.5f, 0.5f,  0, 0, 1,
+     0.5f, 0.5f, 0.5f,  0, 0, 1,
+    -0.5f, 0.5f, 0.5f,  0, 0, 1,
+    -0.5f,-0.5f, 0.5f,  0, 0, 1,
+    // Left
+    -0.5f, 0.5f, 0.5f, -1, 0, 0,
+    -0.5f, 0.5f,-0.5f, -1, 0, 0,
+    -0.5f,-0.5f,-0.5f, -1, 0, 0,
+    -0.5f,-0.5f,-0.5f, -1, 0, 0,
+    -0.5f,-0.5f, 0.5f, -1, 0, 0,
+    -0.5f, 0.5f, 0.5f, -1, 0, 0,
+    // Right
+     0.5f, 0.5f, 0.5f,  1, 0, 0,
+     0.5f,-0.5f,-0.5f,  1, 0, 0,
+     0.5f, 0.5f,-0.5f,  1, 0, 0,
+     0.5f,-0.5f,-0.5f,  1, 0, 0,
+     0.5f, 0.5f, 0.5f,  1, 0, 0,
+     0.5f,-0.5f, 0.5f,  1, 0, 0,
+    // Bottom
+    -0.5f,-0.5f,-0.5f,  0,-1, 0,
+     0.5f,-0.5f,-0.5f,  0,-1, 0,
+     0.5f,-0.5f, 0.5f,  0,-1, 0,
+     0.5f,-0.5f, 0.5f,  0,-1, 0,
+    -0.5f,-0.5f, 0.5f,  0,-1, 0,
+    -0.5f,-0.5f,-0.5f,  0,-1, 0,
+    // Top
+    -0.5f, 0.5f,-0.5f,  0, 1, 0,
+     0.5f, 0.5f, 0.5f,  0, 1, 0,
+     0.5f, 0.5f,-0.5f,  0, 1, 0,
+     0.5f, 0.5f, 0.5f,  0, 1, 0,
+    -0.5f, 0.5f,-0.5f,  0, 1, 0,
+    -0.5f, 0.5f, 0.5f,  0, 1, 0,
+};
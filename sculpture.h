@@ -0,0 +1,196 @@
+#pragma once
+
+#include "fast_trig.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Sculpture animation
+// ─────────────────────────────────────────────────────────────────────────────
+struct CubeState { float gy, spin, s; };
+
+// Closed-form wave motion of the cube at grid position (gx, gz), d = |(gx, gz)|.
+// The four waves go through one 4-wide sincos.
+inline CubeState evalCube(float gx, float gz, float d, float t)
+{
+    float arg[4] = { d * 0.55f - t * 2.f, gx * 0.5f + t * 1.3f, gz * 0.5f - t * 1.1f, t * 3.f + d };
+    float sn[4], cs[4];
+    fast::sincos4(arg, sn, cs);
+    CubeState c;
+    c.gy = 2.0f * sn[0] + 0.8f * sn[1] + 0.8f * cs[2];
+    c.spin = t * 50.f + d * 12.f;
+    c.s = 0.88f + 0.12f * sn[3];
+    return c;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Grid layout
+//  Cubes are stored region-major: each REGION x REGION block of the grid is a
+//  contiguous run of instances, so per-region work touches one buffer range.
+//  Coordinates are mirror-exact about the centre, so the (up to 8) cubes at
+//  (+-x, +-z) and (+-z, +-x) share d bit for bit (unless x*x + z*z is
+//  contracted into an FMA, which only makes more classes); cubes with equal
+//  d form a distance class, and everything that depends only on d is per
+//  class.
+// ─────────────────────────────────────────────────────────────────────────────
+struct SculptureGrid {
+    static const int REGION = 16;
+
+    int   grid;
+    float spacing;
+    std::vector<float> gx, gz, d;       // per instance
+    std::vector<int>   row, col;
+    std::vector<float> colX, rowZ;      // gx of each column, gz of each row
+    std::vector<int>   dClass;          // per instance: index into classD
+    std::vector<float> classD;          // distinct d values, ascending
+    std::vector<int>   regionStart;     // regions + 1 entries
+    std::vector<glm::vec3> regionCentre;
+    float regionRadius;
+
+    SculptureGrid(int grid, float spacing) : grid(grid), spacing(spacing)
+    {
+        float off = (grid - 1) * spacing * 0.5f;
+        for (int i = 0; i < grid; i++) {
+            colX.push_back((2 * i - (grid - 1)) * 0.5f * spacing);
+            rowZ.push_back(colX.back());
+        }
+        int rn = (grid + REGION - 1) / REGION;
+        for (int ry = 0; ry < rn; ry++)
+            for (int rx = 0; rx < rn; rx++) {
+                regionStart.push_back(count());
+                int r1 = std::min(grid, (ry + 1) * REGION), c1 = std::min(grid, (rx + 1) * REGION);
+                for (int r = ry * REGION; r < r1; r++)
+                    for (int c = rx * REGION; c < c1; c++) {
+                        float x = colX[c], z = rowZ[r];
+                        gx.push_back(x); gz.push_back(z); d.push_back(sqrtf(x * x + z * z));
+                        row.push_back(r); col.push_back(c);
+                    }
+                float cx = ((rx * REGION + c1 - 1) * 0.5f) * spacing - off;
+                float cz = ((ry * REGION + r1 - 1) * 0.5f) * spacing - off;
+                regionCentre.push_back({ cx, 0, cz });
+            }
+        regionStart.push_back(count());
+        regionRadius = REGION * spacing * 0.7072f + 4.f;    // half diagonal plus wave height
+
+        classD = d;
+        std::sort(classD.begin(), classD.end());
+        classD.erase(std::unique(classD.begin(), classD.end()), classD.end());
+        dClass.resize(count());
+        for (int i = 0; i < count(); i++)
+            dClass[i] = (int)(std::lower_bound(classD.begin(), classD.end(), d[i]) - classD.begin());
+    }
+
+    int count() const { return (int)gx.size(); }
+    int regions() const { return (int)regionCentre.size(); }
+    int classes() const { return (int)classD.size(); }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Separable evaluation
+//  Two of evalCube's height waves depend only on the column or only on the
+//  row, so for one time they are a table of grid entries each, not one per
+//  cube. The radial wave, spin and scale pulse depend only on d, so at the
+//  frame's time they are one entry per distance class (about an eighth of
+//  the cubes), filled on first use. frame(t) sets that time; eval at any
+//  other time fills just the rows and columns its range spans and evaluates
+//  the d terms per cube, two cubes per 4-wide sincos. Results match evalCube
+//  bit for bit without FP contraction; with -ffp-contract=fast and FMA the
+//  two paths fuse different multiply-adds and differ by a few ulps.
+// ─────────────────────────────────────────────────────────────────────────────
+class CubeWaves {
+public:
+    long long tableTrig = 0, classTrig = 0, cubeTrig = 0;  // scalar sincos evaluated, for reporting
+
+    explicit CubeWaves(const SculptureGrid& g)
+        : g(g), colFrame(g.grid), rowFrame(g.grid), colSpan(g.grid), rowSpan(g.grid),
+          radial(g.classes()), spin(g.classes()), pulse(g.classes()) {}
+
+    void frame(float t)
+    {
+        fill(colFrame, rowFrame, 0, g.grid - 1, 0, g.grid - 1, t);
+        frameT = t;
+        haveFrame = true;
+        haveClasses = false;
+    }
+
+    const float* columns() const { return colFrame.data(); }    // at the last frame(t)
+    const float* rows() const { return rowFrame.data(); }
+
+    // Fills the distance-class tables for the frame's time, after which at()
+    // is read-only and safe to call from any thread
+    void prepare()
+    {
+        if (!haveClasses) fillClasses();
+    }
+
+    // Cube i at the frame's time; needs prepare()
+    CubeState at(int i) const
+    {
+        int k = g.dClass[i];
+        return { 2.0f * radial[k] + colFrame[g.col[i]] + rowFrame[g.row[i]], spin[k], pulse[k] };
+    }
+
+    // Cubes [lo, hi) at time t into out[0, hi - lo)
+    void eval(int lo, int hi, float t, CubeState* out)
+    {
+        if (haveFrame && t == frameT) {
+            prepare();
+            for (int i = lo; i < hi; i++) out[i - lo] = at(i);
+            return;
+        }
+
+        int r0 = g.grid, r1 = -1, c0 = g.grid, c1 = -1;
+        for (int i = lo; i < hi; i++) {
+            r0 = std::min(r0, g.row[i]); r1 = std::max(r1, g.row[i]);
+            c0 = std::min(c0, g.col[i]); c1 = std::max(c1, g.col[i]);
+        }
+        fill(colSpan, rowSpan, c0, c1, r0, r1, t);
+        const float* col = colSpan.data();
+        const float* row = rowSpan.data();
+        for (int i = lo; i < hi; i += 2) {
+            int j = std::min(i + 1, hi - 1);
+            float arg[4] = { g.d[i] * 0.55f - t * 2.f, t * 3.f + g.d[i], g.d[j] * 0.55f - t * 2.f, t * 3.f + g.d[j] };
+            float sn[4], cs[4];
+            fast::sincos4(arg, sn, cs);
+            out[i - lo] = { 2.0f * sn[0] + col[g.col[i]] + row[g.row[i]], t * 50.f + g.d[i] * 12.f, 0.88f + 0.12f * sn[1] };
+            out[j - lo] = { 2.0f * sn[2] + col[g.col[j]] + row[g.row[j]], t * 50.f + g.d[j] * 12.f, 0.88f + 0.12f * sn[3] };
+        }
+        cubeTrig += 2 * (hi - lo);
+    }
+
+private:
+    void fill(std::vector<float>& col, std::vector<float>& row, int c0, int c1, int r0, int r1, float t)
+    {
+        for (int c = c0; c <= c1; c++) col[c] = 0.8f * fast::sin(g.colX[c] * 0.5f + t * 1.3f);
+        for (int r = r0; r <= r1; r++) row[r] = 0.8f * fast::cos(g.rowZ[r] * 0.5f - t * 1.1f);
+        tableTrig += (c1 - c0 + 1) + (r1 - r0 + 1);
+    }
+
+    void fillClasses()
+    {
+        int n = g.classes();
+        float t = frameT;
+        for (int k = 0; k < n; k += 2) {
+            int j = std::min(k + 1, n - 1);
+            float dk = g.classD[k], dj = g.classD[j];
+            float arg[4] = { dk * 0.55f - t * 2.f, t * 3.f + dk, dj * 0.55f - t * 2.f, t * 3.f + dj };
+            float sn[4], cs[4];
+            fast::sincos4(arg, sn, cs);
+            radial[k] = sn[0]; spin[k] = t * 50.f + dk * 12.f; pulse[k] = 0.88f + 0.12f * sn[1];
+            radial[j] = sn[2]; spin[j] = t * 50.f + dj * 12.f; pulse[j] = 0.88f + 0.12f * sn[3];
+        }
+        classTrig += 2 * n;
+        haveClasses = true;
+    }
+
+    const SculptureGrid& g;
+    std::vector<float> colFrame, rowFrame;  // whole grid at frameT
+    std::vector<float> colSpan, rowSpan;    // scratch for other times
+    std::vector<float> radial, spin, pulse; // per distance class at frameT
+    float frameT = 0;
+    bool  haveFrame = false, haveClasses = false;
+};
@@ -0,0 +1,461 @@
+#pragma once
+
+#include "fast_trig.h"
+#include "renderer.h"
+#include "scene.h"
+#include "worker_pool.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFT_SSE 1
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Four pixels at a time
+//  Masks are all-ones/all-zero lanes with SSE and 1/0 in the scalar fallback;
+//  only the helpers below create or consume them.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace soft {
+
+#ifdef SOFT_SSE
+struct F4 {
+    __m128 v;
+    F4() = default;
+    F4(__m128 v) : v(v) {}
+    F4(float f) : v(_mm_set1_ps(f)) {}
+    static F4 ramp(float f) { return _mm_setr_ps(f, f + 1, f + 2, f + 3); }
+    static F4 load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+};
+inline F4 operator+(F4 a, F4 b) { return _mm_add_ps(a.v, b.v); }
+inline F4 operator-(F4 a, F4 b) { return _mm_sub_ps(a.v, b.v); }
+inline F4 operator*(F4 a, F4 b) { return _mm_mul_ps(a.v, b.v); }
+inline F4 operator/(F4 a, F4 b) { return _mm_div_ps(a.v, b.v); }
+inline F4 min(F4 a, F4 b) { return _mm_min_ps(a.v, b.v); }
+inline F4 max(F4 a, F4 b) { return _mm_max_ps(a.v, b.v); }
+inline F4 sqrt(F4 a) { return _mm_sqrt_ps(a.v); }
+inline F4 geq(F4 a, F4 b) { return _mm_cmpge_ps(a.v, b.v); }
+inline F4 less(F4 a, F4 b) { return _mm_cmplt_ps(a.v, b.v); }
+inline F4 both(F4 a, F4 b) { return _mm_and_ps(a.v, b.v); }
+inline F4 select(F4 m, F4 a, F4 b) { return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)); }
+inline int bits(F4 m) { return _mm_movemask_ps(m.v); }
+
+// exp2/log2 by range reduction and degree-5 polynomials (rel. error ~1e-6)
+inline F4 log2(F4 x)
+{
+    __m128i i = _mm_castps_si128(x.v);
+    F4 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(i, 23), _mm_set1_epi32(127)));
+    F4 m = _mm_or_ps(_mm_castsi128_ps(_mm_and_si128(i, _mm_set1_epi32(0x007FFFFF))), _mm_set1_ps(1.f));
+    F4 p = ((((F4(-3.4436006e-2f) * m + 3.1821337e-1f) * m - 1.2315303f) * m + 2.5988452f) * m - 3.3241990f) * m + 3.1157899f;
+    return p * (m - 1.f) + e;
+}
+
+inline F4 exp2(F4 x)
+{
+    x = min(max(x, -126.99999f), 129.f);
+    __m128i ip = _mm_cvtps_epi32(_mm_sub_ps(x.v, _mm_set1_ps(0.5f)));
+    F4 f = x - F4(_mm_cvtepi32_ps(ip));
+    F4 ei = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(ip, _mm_set1_epi32(127)), 23));
+    F4 ef = ((((F4(1.8775767e-3f) * f + 8.9893397e-3f) * f + 5.5826318e-2f) * f + 2.4015361e-1f) * f + 6.9315308e-1f) * f + 9.9999994e-1f;
+    return ei * ef;
+}
+
+// pow(x, e) for x >= 0, with pow(0, e) = 0 as the shader gets it
+inline F4 pow(F4 x, float e) { return select(less(F4(0.f), x), exp2(log2(x) * e), 0.f); }
+#else
+struct F4 {
+    float v[4];
+    F4() = default;
+    F4(float f) { for (float& x : v) x = f; }
+    static F4 ramp(float f) { F4 r; for (int i = 0; i < 4; i++) r.v[i] = f + i; return r; }
+    static F4 load(const float* p) { F4 r; for (int i = 0; i < 4; i++) r.v[i] = p[i]; return r; }
+    void store(float* p) const { for (int i = 0; i < 4; i++) p[i] = v[i]; }
+};
+template <class Op> inline F4 lanes(F4 a, F4 b, Op op) { F4 r; for (int i = 0; i < 4; i++) r.v[i] = op(a.v[i], b.v[i]); return r; }
+inline F4 operator+(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x + y; }); }
+inline F4 operator-(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x - y; }); }
+inline F4 operator*(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x * y; }); }
+inline F4 operator/(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x / y; }); }
+inline F4 min(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return std::min(x, y); }); }
+inline F4 max(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return std::max(x, y); }); }
+inline F4 sqrt(F4 a) { return lanes(a, a, [](float x, float) { return std::sqrt(x); }); }
+inline F4 geq(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x >= y ? 1.f : 0.f; }); }
+inline F4 less(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x < y ? 1.f : 0.f; }); }
+inline F4 both(F4 a, F4 b) { return a * b; }
+inline F4 select(F4 m, F4 a, F4 b) { F4 r; for (int i = 0; i < 4; i++) r.v[i] = m.v[i] != 0 ? a.v[i] : b.v[i]; return r; }
+inline int bits(F4 m) { int r = 0; for (int i = 0; i < 4; i++) r |= (m.v[i] != 0) << i; return r; }
+inline F4 pow(F4 x, float e) { return lanes(x, x, [e](float a, float) { return a > 0 ? std::pow(a, e) : 0.f; }); }
+#endif
+
+inline F4 clamp01(F4 a) { return min(max(a, 0.f), 1.f); }
+
+struct V4 { F4 x, y, z; };
+inline V4 operator-(glm::vec3 a, const V4& b) { return { F4(a.x) - b.x, F4(a.y) - b.y, F4(a.z) - b.z }; }
+inline F4 dot(const V4& a, const V4& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline F4 dot(const V4& a, glm::vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+} // namespace soft
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Software rasterizer
+//  Draws a SceneDesc the way the GL path does: instanced cubes placed by the
+//  same LOD interpolation as the vertex shader, per-pixel lighting with the
+//  shader's dir/point/spot terms, flat-coloured light markers and a depth
+//  test. Front end: workers transform, cull, clip and set up their share of
+//  the instances, binning triangles into 64x64 screen tiles. Back end: workers
+//  take whole tiles, walking each triangle's box four pixels at a time.
+//  The image is stored bottom row first, like glReadPixels.
+// ─────────────────────────────────────────────────────────────────────────────
+class SoftRasterizer : public RenderBackend {
+public:
+    static const int TILE = 64;
+
+    SoftRasterizer(int w, int h, WorkerPool& pool)
+        : width(w), height(h), tilesX((w + TILE - 1) / TILE), tilesY((h + TILE - 1) / TILE), pool(pool),
+          rgb(w * h * 3), depth(pool.size() * TILE * TILE), work(pool.size())
+    {
+        for (Bins& b : work) b.tiles.resize(tilesX * tilesY);
+    }
+
+    // Sculpture elements from a baked mesh (MappedMesh::corners, the
+    // CUBE_VERTS layout) instead of the cube; empty restores the cube
+    void setMesh(std::vector<float> corners) { mesh = std::move(corners); }
+
+    void submit(const SceneDesc& s, const CommandList& cmds) override
+    {
+        scene = &s;
+        viewProj = s.proj * s.view;
+        spotAxis = glm::normalize(-s.spotLight.direction);
+        dirToLight = glm::normalize(-s.dirLight.direction);
+
+        for (Bins& b : work) {
+            b.tris.clear();
+            for (std::vector<uint32_t>& t : b.tiles) t.clear();
+        }
+
+        // Instances of all cube runs, split evenly across the workers
+        runs.clear(); runStart.clear();
+        int total = 0;
+        for (const DrawCmd& c : cmds.commands())
+            if (c.kind == DrawCmd::Cubes) { runStart.push_back(total); total += c.count; runs.push_back(c); }
+        pool.parallelFor(0, total, [&](int lo, int hi, unsigned w) {
+            size_t r = std::upper_bound(runStart.begin(), runStart.end(), lo) - runStart.begin() - 1;
+            for (int k = lo; k < hi; k++) {
+                while (r + 1 < runStart.size() && runStart[r + 1] <= k) r++;
+                addCube(runs[r].first + k - runStart[r], work[w]);
+            }
+        });
+        for (const DrawCmd& c : cmds.commands())
+            if (c.kind == DrawCmd::Marker) addMarker(c.first, work[0]);
+
+        std::atomic<int> next(0);
+        pool.run([&](unsigned w) {
+            for (int t; (t = next++) < tilesX * tilesY; )
+                drawTile(t, &depth[w * TILE * TILE]);
+        });
+    }
+
+    const std::vector<float>& colour() const { return rgb; }
+
+    int triangles() const
+    {
+        int n = 0;
+        for (const Bins& b : work) n += (int)b.tris.size();
+        return n;
+    }
+
+    bool writePpm(const std::string& path) const
+    {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        fprintf(f, "P6\n%d %d\n255\n", width, height);
+        std::vector<unsigned char> row(width * 3);
+        for (int y = height - 1; y >= 0; y--) {
+            for (int i = 0; i < width * 3; i++)
+                row[i] = (unsigned char)(std::clamp(rgb[y * width * 3 + i], 0.f, 1.f) * 255.f + 0.5f);
+            fwrite(row.data(), 1, row.size(), f);
+        }
+        fclose(f);
+        return true;
+    }
+
+private:
+    // Screen-space triangle: barycentrics and attributes as planes a*x + b*y + c,
+    // x and y from the corner (x0, y0) of its bounds so that tiny triangles
+    // far from the screen origin keep their precision
+    struct Plane { float a, b, c; };
+    struct Tri {
+        Plane     bary[3], z, iw, pw[3], nw[3];     // world position, normal / w
+        int       x0, y0, x1, y1;                   // pixel bounds, inclusive
+        glm::vec3 normal, flat;                     // flat colour for markers
+        bool      lit, smooth;                      // smooth: nw per pixel, not normal
+    };
+    struct Bins {
+        std::vector<Tri> tris;
+        std::vector<std::vector<uint32_t>> tiles;
+    };
+    struct ClipVert { glm::vec4 clip; glm::vec3 world, normal; };
+
+    void addCube(int i, Bins& out)
+    {
+        const SceneDesc& s = *scene;
+        const InstanceState& st = s.states[i];
+        float span = st.s1.w - st.s0.w;
+        float f = span > 0 ? std::clamp((s.animTime - st.s0.w) / span, 0.f, 1.f) : 1.f;
+        glm::vec3 v = glm::vec3(st.s0) + (glm::vec3(st.s1) - glm::vec3(st.s0)) * f;
+
+        float c, sn;
+        fast::sincos(glm::radians(v.y), sn, c);
+        glm::mat3 rot(glm::vec3(c, 0, -sn), glm::vec3(0, 1, 0), glm::vec3(sn, 0, c));
+        glm::mat4 model(glm::vec4(rot[0] * v.z, 0), glm::vec4(rot[1] * v.z, 0), glm::vec4(rot[2] * v.z, 0),
+                        glm::vec4(s.base[i].x, v.x, s.base[i].y, 1));
+        if (mesh.empty()) addMesh(CUBE_VERTS, 12, model, rot, true, {}, out);
+        else addMesh(mesh.data(), (int)mesh.size() / 18, model, rot, true, {}, out);
+    }
+
+    void addMarker(int i, Bins& out)
+    {
+        const SceneDesc& s = *scene;
+        addMesh(CUBE_VERTS, 12, markerModel(s.pointLights[i].position, s.markerSize), glm::mat3(1), false, s.markerColour[i], out);
+    }
+
+    // tris triangles of pos + normal corners, the normals interpolated like
+    // the vertex shader's output
+    void addMesh(const float* verts, int tris, const glm::mat4& model, const glm::mat3& rot, bool lit, glm::vec3 flat, Bins& out)
+    {
+        for (int t = 0; t < tris; t++) {
+            const float* p = &verts[t * 18];
+            ClipVert v[3];
+            for (int k = 0; k < 3; k++) {
+                v[k].world = glm::vec3(model * glm::vec4(p[k * 6], p[k * 6 + 1], p[k * 6 + 2], 1));
+                v[k].clip = viewProj * glm::vec4(v[k].world, 1);
+                v[k].normal = rot * glm::vec3(p[k * 6 + 3], p[k * 6 + 4], p[k * 6 + 5]);
+            }
+            // Closed meshes: faces wound away from the eye are always hidden
+            glm::vec3 face = glm::cross(v[1].world - v[0].world, v[2].world - v[0].world);
+            if (glm::dot(face, v[0].world - scene->viewPos) >= 0) continue;
+            clipAndSetup(v, lit, flat, out);
+        }
+    }
+
+    // Clip against the near and far planes, then fan the polygon
+    void clipAndSetup(const ClipVert in[3], bool lit, glm::vec3 flat, Bins& out)
+    {
+        ClipVert a[5], b[5];
+        int na = 3;
+        for (int k = 0; k < 3; k++) a[k] = in[k];
+        for (int plane = 0; plane < 2; plane++) {
+            auto dist = [plane](const ClipVert& v) { return plane == 0 ? v.clip.z + v.clip.w : v.clip.w - v.clip.z; };
+            int nb = 0;
+            for (int k = 0; k < na; k++) {
+                const ClipVert& p = a[k];
+                const ClipVert& q = a[(k + 1) % na];
+                float dp = dist(p), dq = dist(q);
+                if (dp >= 0) b[nb++] = p;
+                if ((dp >= 0) != (dq >= 0)) {
+                    float t = dp / (dp - dq);
+                    b[nb++] = { p.clip + (q.clip - p.clip) * t, p.world + (q.world - p.world) * t,
+                                p.normal + (q.normal - p.normal) * t };
+                }
+            }
+            if (nb < 3) return;
+            na = nb;
+            for (int k = 0; k < na; k++) a[k] = b[k];
+        }
+        for (int k = 1; k + 1 < na; k++)
+            setup(a[0], a[k], a[k + 1], lit, flat, out);
+    }
+
+    void setup(const ClipVert& v0, const ClipVert& v1, const ClipVert& v2, bool lit, glm::vec3 flat, Bins& out)
+    {
+        const ClipVert* v[3] = { &v0, &v1, &v2 };
+        float x[3], y[3], z[3], iw[3];
+        glm::vec3 pw[3], nw[3];
+        for (int k = 0; k < 3; k++) {
+            iw[k] = 1.f / v[k]->clip.w;
+            x[k] = (v[k]->clip.x * iw[k] * 0.5f + 0.5f) * width;
+            y[k] = (v[k]->clip.y * iw[k] * 0.5f + 0.5f) * height;
+            z[k] = v[k]->clip.z * iw[k];
+            pw[k] = v[k]->world * iw[k];
+            nw[k] = v[k]->normal * iw[k];
+        }
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (fabsf(area) < 1e-8f) return;
+
+        Tri t;
+        t.x0 = std::max(0, (int)floorf(std::min({ x[0], x[1], x[2] })));
+        t.y0 = std::max(0, (int)floorf(std::min({ y[0], y[1], y[2] })));
+        t.x1 = std::min(width - 1, (int)ceilf(std::max({ x[0], x[1], x[2] })));
+        t.y1 = std::min(height - 1, (int)ceilf(std::max({ y[0], y[1], y[2] })));
+        if (t.x0 > t.x1 || t.y0 > t.y1) return;
+        for (int k = 0; k < 3; k++) { x[k] -= t.x0; y[k] -= t.y0; }
+
+        float inv = 1.f / area;
+        for (int k = 0; k < 3; k++) {
+            int i = (k + 1) % 3, j = (k + 2) % 3;
+            t.bary[k] = { (y[i] - y[j]) * inv, (x[j] - x[i]) * inv, (x[i] * y[j] - x[j] * y[i]) * inv };
+        }
+        auto plane = [&](float f0, float f1, float f2) {
+            return Plane{ t.bary[0].a * f0 + t.bary[1].a * f1 + t.bary[2].a * f2,
+                          t.bary[0].b * f0 + t.bary[1].b * f1 + t.bary[2].b * f2,
+                          t.bary[0].c * f0 + t.bary[1].c * f1 + t.bary[2].c * f2 };
+        };
+        t.z = plane(z[0], z[1], z[2]);
+        t.iw = plane(iw[0], iw[1], iw[2]);
+        for (int c = 0; c < 3; c++) t.pw[c] = plane(pw[0][c], pw[1][c], pw[2][c]);
+        // Flat faces (the cube, markers) skip the per-pixel normal
+        t.smooth = v0.normal != v1.normal || v0.normal != v2.normal;
+        if (t.smooth)
+            for (int c = 0; c < 3; c++) t.nw[c] = plane(nw[0][c], nw[1][c], nw[2][c]);
+        t.normal = glm::normalize(v0.normal);
+        t.flat = flat;
+        t.lit = lit;
+
+        uint32_t id = (uint32_t)out.tris.size();
+        out.tris.push_back(t);
+        for (int ty = t.y0 / TILE; ty <= t.y1 / TILE; ty++)
+            for (int tx = t.x0 / TILE; tx <= t.x1 / TILE; tx++)
+                out.tiles[ty * tilesX + tx].push_back(id);
+    }
+
+    void drawTile(int tile, float* zbuf)
+    {
+        int tx = tile % tilesX, ty = tile / tilesX;
+        int ox = tx * TILE, oy = ty * TILE;
+        int w = std::min(TILE, width - ox), h = std::min(TILE, height - oy);
+
+        std::fill(zbuf, zbuf + TILE * TILE, 1.f);
+        for (int y = 0; y < h; y++) {
+            float* row = &rgb[((oy + y) * width + ox) * 3];
+            for (int x = 0; x < w; x++) {
+                row[x * 3] = scene->clear.x; row[x * 3 + 1] = scene->clear.y; row[x * 3 + 2] = scene->clear.z;
+            }
+        }
+
+        for (const Bins& b : work)
+            for (uint32_t id : b.tiles[tile])
+                drawTri(b.tris[id], ox, oy, w, h, zbuf);
+    }
+
+    void drawTri(const Tri& t, int ox, int oy, int w, int h, float* zbuf)
+    {
+        using namespace soft;
+        int x0 = (std::max(t.x0, ox) - ox) & ~3, x1 = std::min(t.x1, ox + w - 1) - ox;
+        int y0 = std::max(t.y0, oy) - oy, y1 = std::min(t.y1, oy + h - 1) - oy;
+
+        soft::F4 xEnd(ox + x1 + 1.f - t.x0);    // lanes past the box may be past the row
+        for (int y = y0; y <= y1; y++) {
+            float py = oy + y - t.y0 + 0.5f;
+            for (int x = x0; x <= x1; x += 4) {
+                F4 px = F4::ramp(ox + x - t.x0 + 0.5f);
+                auto at = [&](const Plane& p) { return F4(p.a) * px + F4(p.b * py + p.c); };
+
+                F4 inside = both(both(geq(at(t.bary[0]), 0.f), geq(at(t.bary[1]), 0.f)),
+                                 both(geq(at(t.bary[2]), 0.f), less(px, xEnd)));
+                if (!bits(inside)) continue;
+
+                float* zp = &zbuf[y * TILE + x];
+                F4 z = at(t.z), zOld = F4::load(zp);
+                F4 pass = both(inside, less(z, zOld));
+                int m = bits(pass);
+                if (!m) continue;
+                select(pass, z, zOld).store(zp);
+
+                float r[4], g[4], bl[4];
+                if (t.lit) {
+                    F4 iw = F4(1.f) / at(t.iw);
+                    V4 fp = { at(t.pw[0]) * iw, at(t.pw[1]) * iw, at(t.pw[2]) * iw };
+                    V4 n = { F4(t.normal.x), F4(t.normal.y), F4(t.normal.z) };
+                    if (t.smooth) {
+                        n = { at(t.nw[0]) * iw, at(t.nw[1]) * iw, at(t.nw[2]) * iw };
+                        F4 nl = F4(1.f) / sqrt(dot(n, n));
+                        n = { n.x * nl, n.y * nl, n.z * nl };
+                    }
+                    V4 c = shade(fp, n);
+                    c.x.store(r); c.y.store(g); c.z.store(bl);
+                }
+                else
+                    for (int k = 0; k < 4; k++) { r[k] = t.flat.x; g[k] = t.flat.y; bl[k] = t.flat.z; }
+
+                float* out = &rgb[((oy + y) * width + ox + x) * 3];
+                for (int k = 0; k < 4; k++)
+                    if (m & (1 << k)) { out[k * 3] = r[k]; out[k * 3 + 1] = g[k]; out[k * 3 + 2] = bl[k]; }
+            }
+        }
+    }
+
+    // CalcDirLight + CalcPointLight + CalcSpotLight from the fragment shader,
+    // at positions fp with unit normals n
+    soft::V4 shade(const soft::V4& fp, const soft::V4& n) const
+    {
+        using namespace soft;
+        const SceneDesc& s = *scene;
+        const Material& mat = s.mat;
+
+        V4 v = s.viewPos - fp;
+        F4 vl = F4(1.f) / sqrt(dot(v, v));
+        v = { v.x * vl, v.y * vl, v.z * vl };
+
+        auto specular = [&](const V4& d, F4 nd) {
+            // r = reflect(-d, n) = 2 (n.d) n - d
+            V4 r = { F4(2.f) * nd * n.x - d.x, F4(2.f) * nd * n.y - d.y, F4(2.f) * nd * n.z - d.z };
+            return pow(max(dot(v, r), 0.f), mat.shininess);
+        };
+
+        const DirLight& D = s.dirLight;
+        F4 ndl = dot(n, dirToLight);
+        F4 dd = max(ndl, 0.f);
+        glm::vec3 ka = D.ambient * mat.diffuse, kd = D.diffuse * mat.diffuse;
+        V4 dl = { F4(dirToLight.x), F4(dirToLight.y), F4(dirToLight.z) };
+        F4 ds = specular(dl, ndl);
+        V4 c = { F4(ka.x) + dd * kd.x + ds * (D.specular.x * mat.specular.x),
+                 F4(ka.y) + dd * kd.y + ds * (D.specular.y * mat.specular.y),
+                 F4(ka.z) + dd * kd.z + ds * (D.specular.z * mat.specular.z) };
+
+        auto local = [&](glm::vec3 pos, float k0, float k1, float k2, glm::vec3 amb, glm::vec3 dif, glm::vec3 spe,
+                         const SpotLight* spot) {
+            V4 d = pos - fp;
+            F4 dist = sqrt(dot(d, d));
+            F4 id = F4(1.f) / dist;
+            d = { d.x * id, d.y * id, d.z * id };
+            F4 nd = dot(d, n);
+            F4 diff = max(nd, 0.f);
+            F4 spec = specular(d, nd);
+            F4 att = F4(1.f) / (F4(k0) + F4(k1) * dist + F4(k2) * dist * dist);
+            if (spot) {
+                F4 theta = dot(d, spotAxis);
+                att = att * clamp01((theta - spot->outerCutOff) / F4(spot->cutOff - spot->outerCutOff));
+            }
+            glm::vec3 a = amb * mat.diffuse, df = dif * mat.diffuse, sp = spe * mat.specular;
+            c.x = c.x + (F4(a.x) + diff * df.x + spec * sp.x) * att;
+            c.y = c.y + (F4(a.y) + diff * df.y + spec * sp.y) * att;
+            c.z = c.z + (F4(a.z) + diff * df.z + spec * sp.z) * att;
+        };
+        for (const PointLight& L : s.pointLights)
+            local(L.position, L.constant, L.linear, L.quadratic, L.ambient, L.diffuse, L.specular, nullptr);
+        const SpotLight& S = s.spotLight;
+        local(S.position, S.constant, S.linear, S.quadratic, S.ambient, S.diffuse, S.specular, &S);
+        return c;
+    }
+
+    int width, height, tilesX, tilesY;
+    WorkerPool& pool;
+    std::vector<float> rgb, depth;      // depth: one tile of scratch per worker
+    std::vector<Bins>  work;            // per front-end worker
+    std::vector<DrawCmd> runs;          // cube commands of the current submit
+    std::vector<float> mesh;            // baked sculpture element, empty for the cube
+    std::vector<int>   runStart;        // their first index in the flattened order
+    const SceneDesc* scene = nullptr;
+    glm::mat4 viewProj{ 1.f };
+    glm::vec3 spotAxis{ 0.f }, dirToLight{ 0.f };
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "scene.h"
+#include "sculpture.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Distance at which a point light's brightest diffuse or specular channel,
+// attenuated by 1 / (constant + linear d + quadratic d^2), falls to cutoff
+inline float lightRange(const PointLight& L, float cutoff)
+{
+    float peak = std::max({ L.diffuse.x, L.diffuse.y, L.diffuse.z, L.specular.x, L.specular.y, L.specular.z });
+    float k = L.constant - peak / cutoff;
+    if (k >= 0) return 0;
+    if (L.quadratic <= 0) return L.linear > 0 ? -k / L.linear : INFINITY;
+    return (-L.linear + sqrtf(L.linear * L.linear - 4 * L.quadratic * k)) / (2 * L.quadratic);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Spatial grid
+//  Uniform cells over the sculpture's footprint in x/z, each cell x cell
+//  cubes with edges halfway between cube columns, so a cube's cell is just
+//  its row and column divided by cell. Cubes only move in y: they are
+//  bucketed once, cell by cell in one array, and queries test the heights
+//  they are given. Each point light is listed in every cell its range
+//  square overlaps; update() moves a light only between the cells it
+//  entered or left. Anything outside the footprint clamps to the edge.
+// ─────────────────────────────────────────────────────────────────────────────
+class SpatialGrid {
+public:
+    static constexpr float CUBE_RADIUS = 0.8660254f;   // half diagonal of a unit cube
+    float cutoff = 1.f / 256;       // a light reaches as far as it adds more than this
+    long long cellEdits = 0;        // light entries added or removed, for reporting
+
+    explicit SpatialGrid(const SculptureGrid& g, int cell = 4)
+        : g(g), cell(std::max(1, cell)), cells((g.grid + this->cell - 1) / this->cell),
+          size(this->cell * g.spacing), origin(g.colX[0] - g.spacing * 0.5f)
+    {
+        cubeStart.assign(cells * cells + 1, 0);
+        for (int i = 0; i < g.count(); i++) cubeStart[cubeCell(i) + 1]++;
+        for (int c = 0; c < cells * cells; c++) cubeStart[c + 1] += cubeStart[c];
+        cubeIds.resize(g.count());
+        std::vector<int> fill(cubeStart.begin(), cubeStart.end() - 1);
+        for (int i = 0; i < g.count(); i++) cubeIds[fill[cubeCell(i)]++] = i;
+        cellLights.resize(cells * cells);
+    }
+
+    int cellsPerSide() const { return cells; }
+    int cubesPerCell() const { return cell; }
+    float range(int light) const { return lights[light].range; }
+
+    // Lights at their current positions. Only the cells a light entered or
+    // left change; a different light count starts over.
+    void update(const std::vector<PointLight>& pl)
+    {
+        if (pl.size() != lights.size()) {
+            for (auto& c : cellLights) c.clear();
+            lights.assign(pl.size(), Light{});
+        }
+        for (size_t i = 0; i < pl.size(); i++) {
+            Light& L = lights[i];
+            L.pos = pl[i].position;
+            L.range = lightRange(pl[i], cutoff);
+            Rect r = rectOf(L.pos.x, L.pos.z, L.range + CUBE_RADIUS);
+            if (r == L.rect) continue;
+            for (int z = L.rect.z0; z <= L.rect.z1; z++)
+                for (int x = L.rect.x0; x <= L.rect.x1; x++)
+                    if (!r.contains(x, z)) remove(cellLights[z * cells + x], (int)i);
+            for (int z = r.z0; z <= r.z1; z++)
+                for (int x = r.x0; x <= r.x1; x++)
+                    if (!L.rect.contains(x, z)) { cellLights[z * cells + x].push_back((int)i); cellEdits++; }
+            L.rect = r;
+        }
+    }
+
+    // From scratch, for comparison with update()
+    void rebuild(const std::vector<PointLight>& pl)
+    {
+        for (auto& c : cellLights) c.clear();
+        lights.assign(pl.size(), Light{});
+        update(pl);
+    }
+
+    // Lights whose range reaches cube i at height y, appended to out
+    void lightsAffecting(int i, float y, std::vector<int>& out) const
+    {
+        glm::vec3 c(g.gx[i], y, g.gz[i]);
+        for (int l : cellLights[cubeCell(i)]) {
+            glm::vec3 d = lights[l].pos - c;
+            float r = lights[l].range + CUBE_RADIUS;
+            if (glm::dot(d, d) <= r * r) out.push_back(l);
+        }
+    }
+
+    // Cubes whose centre is within r of p, heights y per instance, appended
+    // to out
+    void cubesWithin(glm::vec3 p, float r, const float* y, std::vector<int>& out) const
+    {
+        Rect rc = rectOf(p.x, p.z, r);
+        for (int z = rc.z0; z <= rc.z1; z++)
+            for (int x = rc.x0; x <= rc.x1; x++)
+                for (int k = cubeStart[z * cells + x]; k < cubeStart[z * cells + x + 1]; k++) {
+                    int i = cubeIds[k];
+                    glm::vec3 d(g.gx[i] - p.x, y[i] - p.y, g.gz[i] - p.z);
+                    if (glm::dot(d, d) <= r * r) out.push_back(i);
+                }
+    }
+
+private:
+    struct Rect {                   // inclusive cell range, empty when x0 > x1
+        int x0 = 0, z0 = 0, x1 = -1, z1 = -1;
+        bool contains(int x, int z) const { return x >= x0 && x <= x1 && z >= z0 && z <= z1; }
+        bool operator==(const Rect& o) const { return x0 == o.x0 && z0 == o.z0 && x1 == o.x1 && z1 == o.z1; }
+    };
+
+    struct Light {
+        glm::vec3 pos{ 0.f };
+        float range = 0;
+        Rect  rect;
+    };
+
+    int cubeCell(int i) const { return g.row[i] / cell * cells + g.col[i] / cell; }
+
+    // Cells the square (x +- r, z +- r) overlaps; an infinite r covers all
+    Rect rectOf(float x, float z, float r) const
+    {
+        auto lo = [&](float v) { return std::clamp(floorf((v - r - origin) / size), -1.f, (float)cells); };
+        auto hi = [&](float v) { return std::clamp(floorf((v + r - origin) / size), -1.f, (float)cells); };
+        Rect rc{ (int)lo(x), (int)lo(z), (int)hi(x), (int)hi(z) };
+        if (rc.x1 < 0 || rc.z1 < 0 || rc.x0 >= cells || rc.z0 >= cells) return Rect{};
+        rc.x0 = std::max(rc.x0, 0); rc.z0 = std::max(rc.z0, 0);
+        rc.x1 = std::min(rc.x1, cells - 1); rc.z1 = std::min(rc.z1, cells - 1);
+        return rc;
+    }
+
+    void remove(std::vector<int>& v, int light)
+    {
+        auto it = std::find(v.begin(), v.end(), light);
+        if (it == v.end()) return;
+        *it = v.back();
+        v.pop_back();
+        cellEdits++;
+    }
+
+    const SculptureGrid& g;
+    int   cell, cells;              // cubes per cell edge, cells per side
+    float size, origin;             // cell edge length, x/z of the first cell edge
+    std::vector<int> cubeStart;     // cells^2 + 1 entries into cubeIds
+    std::vector<int> cubeIds;       // cubes, cell by cell
+    std::vector<std::vector<int>> cellLights;
+    std::vector<Light> lights;
+};
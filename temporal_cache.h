@@ -0,0 +1,67 @@
+#pragma once
+
+#include "gl_util.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Temporal lighting cache
+//  The sculpture is rendered into one of two RGBA16F targets (rgb = lit colour,
+//  a = view depth) while the other holds last frame's result. The cached
+//  fragment shader re-shades a rotating quarter of the screen and reprojects
+//  the rest through per-pixel motion vectors, falling back to full shading on
+//  disocclusion. Velocity and depth are shared with the other temporal passes.
+// ─────────────────────────────────────────────────────────────────────────────
+class TemporalCache {
+public:
+    GLuint velocity = 0, depth = 0;
+
+    void init(int w, int h)
+    {
+        for (int i = 0; i < 2; i++)
+            colour[i] = makeTexture(w, h, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        velocity = makeTexture(w, h, GL_RG16F, GL_RG, GL_FLOAT, GL_NEAREST);
+        depth = makeTexture(w, h, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT, GL_NEAREST);
+        for (int i = 0; i < 2; i++)
+            fbo[i] = makeFramebuffer({ colour[i], velocity }, depth);
+    }
+
+    void destroy()
+    {
+        glDeleteFramebuffers(2, fbo);
+        glDeleteTextures(2, colour);
+        glDeleteTextures(1, &velocity);
+        glDeleteTextures(1, &depth);
+    }
+
+    // Binds this frame's target and clears it; background has depth 0 so it
+    // never passes the reprojection test.
+    void begin(glm::vec3 clearColour)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo[cur]);
+        const float c[4] = { clearColour.x, clearColour.y, clearColour.z, 0.f }, v[4] = {};
+        glClearBufferfv(GL_COLOR, 0, c);
+        glClearBufferfv(GL_COLOR, 1, v);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    // Program uniforms for the cached shader; history is bound to unit 0.
+    void bind(GLuint prog) const
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, colour[cur ^ 1]);
+        setInt(prog, "history", 0);
+        setInt(prog, "shadePhase", frame & 3);
+        setInt(prog, "historyValid", valid ? 1 : 0);
+    }
+
+    void   end() { cur ^= 1; frame++; valid = true; }
+    void   invalidate() { valid = false; }
+    GLuint target() const { return fbo[cur]; }
+    GLuint output() const { return colour[cur ^ 1]; }     // valid after end()
+    GLuint outputFbo() const { return fbo[cur ^ 1]; }
+
+private:
+    GLuint colour[2] = {}, fbo[2] = {};
+    int    cur = 0;
+    unsigned frame = 0;
+    bool   valid = false;
+};
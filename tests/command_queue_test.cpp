@@ -0,0 +1,127 @@
+// MpscQueue under contention: 1 to 16 producer threads push numbered items
+// while one thread pops; every item must arrive exactly once and in order
+// per producer (exit code 1 otherwise). Throughput is compared with a
+// mutex-guarded queue of the same size. A full CommandQueue must still
+// deliver quit and the toggles. Needs no GL; from the repository
+// root:
+//   g++ -std=c++17 -O2 -pthread -I. tests/command_queue_test.cpp -o command_queue_test && ./command_queue_test
+
+#include "command_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Bounded queue with a mutex, the same interface as MpscQueue: the baseline
+template <class T, size_t N>
+class LockedQueue {
+public:
+    using value_type = T;
+
+    bool push(const T& v)
+    {
+        std::lock_guard<std::mutex> l(m);
+        if (items.size() == N) return false;
+        items.push_back(v);
+        return true;
+    }
+    bool pop(T& out)
+    {
+        std::lock_guard<std::mutex> l(m);
+        if (items.empty()) return false;
+        out = items.front();
+        items.pop_front();
+        return true;
+    }
+private:
+    std::mutex m;
+    std::deque<T> items;
+};
+
+// P producers push numbered items into Q as fast as they can while this
+// thread pops; every item must arrive exactly once and in order per
+// producer. Returns millions of items per second, or -1 on a violation.
+template <class Q>
+double queueStress(Q& q, int producers, int perProducer)
+{
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+        threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int s = 0; s < perProducer; s++)
+                while (!q.push({ (uint32_t)p, (uint32_t)s })) std::this_thread::yield();
+        });
+
+    std::vector<uint32_t> next(producers, 0);
+    long long total = (long long)producers * perProducer, got = 0;
+    bool ok = true;
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    typename Q::value_type v;
+    while (got < total) {
+        if (!q.pop(v)) { std::this_thread::yield(); continue; }
+        ok = ok && v.producer < (uint32_t)producers && v.seq == next[v.producer];
+        if (v.producer < (uint32_t)producers) next[v.producer] = v.seq + 1;
+        got++;
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (auto& t : threads) t.join();
+    ok = ok && !q.pop(v);
+    return ok ? total / sec * 1e-6 : -1;
+}
+
+// A full CommandQueue drops camera input but still delivers quit and the
+// toggles, each as often as it was pushed
+static bool keepsCommands()
+{
+    CommandQueue<4> q;
+    bool ok = true;
+    for (int i = 0; i < 4; i++) ok = ok && q.push({ Command::Look, 1, 1 });
+    ok = ok && !q.push({ Command::Zoom, 1 });
+    ok = ok && q.push({ Command::TogglePause }) && q.push({ Command::TogglePause }) && q.push({ Command::Quit });
+    int looks = 0, pauses = 0, quits = 0, other = 0;
+    q.drain([&](const Command& c) {
+        looks += c.type == Command::Look;
+        pauses += c.type == Command::TogglePause;
+        quits += c.type == Command::Quit;
+        other += c.type != Command::Look && c.type != Command::TogglePause && c.type != Command::Quit;
+    });
+    ok = ok && looks == 4 && pauses == 2 && quits == 1 && other == 0 && q.dropped() == 1;
+    std::cout << "[queue] full command queue: " << looks << " looks, " << pauses << " pauses, " << quits << " quits, "
+              << q.dropped() << " dropped" << (ok ? "\n" : " (expected 4, 2, 1, 1)\n");
+    return ok;
+}
+
+int main()
+{
+    struct Item { uint32_t producer, seq; };
+    using Lockfree = MpscQueue<Item, 1024>;
+    using Locked = LockedQueue<Item, 1024>;
+    const int PER_THREAD = 1 << 20;
+    bool ok = keepsCommands();
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (int producers : { 1, 2, 4, 8, 16 }) {
+        auto lf = std::make_unique<Lockfree>();
+        auto lk = std::make_unique<Locked>();
+        int per = PER_THREAD / producers;
+        double a = queueStress(*lf, producers, per), b = queueStress(*lk, producers, per);
+        ok = ok && a > 0 && b > 0;
+        std::cout << "[queue] " << producers << " producers, " << (long long)producers * per << " items: lock-free ";
+        if (a > 0) std::cout << a << " M/s"; else std::cout << "FAILED";
+        std::cout << ", mutex ";
+        if (b > 0) std::cout << b << " M/s"; else std::cout << "FAILED";
+        if (a > 0 && b > 0) std::cout << " (" << a / b << "x)";
+        std::cout << ", " << lf->dropped() << " pushes rejected while full\n";
+    }
+    std::cout << "[queue] capacity " << MpscQueue<Item, 1024>::capacity() << ", " << hw << " hardware threads"
+              << (ok ? "\n" : "\n[queue] FAILED\n");
+    return ok ? 0 : 1;
+}
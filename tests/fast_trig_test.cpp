@@ -0,0 +1,53 @@
+// fast_trig.h against double-precision sin/cos: the error bound up to
+// MAX_ARG and scalar/4-wide agreement. Exit code 1 on failure.
+// Needs no GL; from the repository root:
+//   g++ -std=c++17 -O2 -ffp-contract=off -I. tests/fast_trig_test.cpp -o fast_trig_test && ./fast_trig_test
+// (with contraction on, the scalar path may fuse multiply-adds that the
+// 4-wide path does not, and the two stop agreeing bit for bit)
+
+#include "fast_trig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+int main()
+{
+    double fastErr = 0, libmErr = 0, worstX = 0;
+    long long checked = 0, mismatch = 0;
+    auto check = [&](float x) {
+        float s, c, s4[4], c4[4], x4[4] = { x, -x, x * 0.5f, x };
+        fast::sincos(x, s, c);
+        fast::sincos4(x4, s4, c4);
+        mismatch += s != s4[0] || c != c4[0] || s != s4[3] || c != c4[3] || fast::sin(x) != s || fast::cos(x) != c;
+        float sn, cn, sh, ch;
+        fast::sincos(-x, sn, cn);
+        fast::sincos(x * 0.5f, sh, ch);
+        mismatch += sn != s4[1] || cn != c4[1] || sh != s4[2] || ch != c4[2];
+        double e = std::max(fabs(s - sin((double)x)), fabs(c - cos((double)x)));
+        if (e > fastErr) { fastErr = e; worstX = x; }
+        libmErr = std::max(libmErr, std::max(fabs(sinf(x) - sin((double)x)), fabs(cosf(x) - cos((double)x))));
+        checked++;
+    };
+    // Dense around zero, the 256 floats from each multiple of pi/2 (where
+    // the quadrant flips) out to 32 pi and below MAX_ARG, then uniform out
+    // to MAX_ARG
+    for (int i = -1000000; i <= 1000000; i++) check(i * (6.2831853f / 1000000.f));
+    for (int k = -64; k <= 64; k++)
+        for (int q : { k, k < 0 ? k - 65471 : k + 65471 }) {
+            float x = q * 1.5707963f;
+            for (int i = 0; i < 256 && fabsf(x) <= fast::MAX_ARG; i++) { check(x); x = nextafterf(x, INFINITY); }
+        }
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> wide(-fast::MAX_ARG, fast::MAX_ARG);
+    for (int i = 0; i < 8000000; i++) check(wide(rng));
+
+    bool ok = fastErr <= fast::MAX_ABS_ERROR && mismatch == 0;
+    std::cout << "[trig] " << checked << " arguments up to " << fast::MAX_ARG << "\n";
+    std::cout << "[trig] max abs error " << fastErr << " at x = " << worstX << " (bound " << fast::MAX_ABS_ERROR
+              << ", libm sinf/cosf " << libmErr << ")\n";
+    std::cout << "[trig] scalar/4-wide mismatches " << mismatch << "\n";
+    std::cout << (ok ? "[trig] passed\n" : "[trig] FAILED\n");
+    return ok ? 0 : 1;
+}
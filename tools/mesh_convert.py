@@ -0,0 +1,638 @@
+#!/usr/bin/env python3
+"""Bake a mesh into the sculpture's binary mesh format (.ksm).
+
+Reads a Wavefront OBJ or a glTF 2.0 file (.gltf or .glb), or generates a
+built-in shape, and writes the layout mesh_file.h maps at startup: a 64-byte
+header, then 12-byte vertices (half-float position, 10:10:10 normal), then
+u16 or u32 indices, each section on a 64-byte boundary.
+
+    tools/mesh_convert.py model.obj -o model.ksm
+    tools/mesh_convert.py --shape rounded-cube -o rounded.ksm
+    ./kinetic --mesh rounded.ksm
+
+On the way the mesh is fitted into the unit cube the sculpture is laid out
+for (unless --no-fit) and vertices that quantize to the same bits are
+merged. Then, for the GPU:
+
+    vertex cache  triangles reordered so recently transformed vertices are
+                  reused: Forsyth's scoring or Tipsify's fans (--order)
+    overdraw      the ordered list is cut into clusters where the cache
+                  starts over (and, within --overdraw of the cluster's own
+                  miss ratio, where it is cheap to cut), and clusters facing
+                  outwards go first, so they tend to occlude the rest
+    vertex fetch  vertices renumbered in the order the triangles first use
+                  them, so fetches walk the buffer forwards
+    meshlets      the final order cut into runs of at most 64 vertices and
+                  124 triangles, also where a triangle turns more than
+                  --meshlet-angle from the run's average normal; each gets a
+                  bounding sphere and a cone of its face normals, which the
+                  GPU culls against the frustum and the eye per instance
+
+Each stage reports ACMR (vertex shader runs per triangle), ATVR (runs per
+vertex, 1.0 is ideal) on a --cache entry FIFO, and overfetch (bytes of
+64-byte lines read through a small cache per byte of vertex data).
+
+OBJ: v, vn and f lines; polygons are fanned. glTF: POSITION, NORMAL and
+indices of every triangle primitive, node transforms ignored. Missing
+normals are computed, smooth, from the faces around each position.
+
+Shapes:
+    cube          the default element, 24 vertices
+    prism         triangular prism standing on the xz plane
+    rounded-cube  cube with rounded edges (--segments, --radius)
+"""
+
+import argparse
+import base64
+import json
+import math
+import os
+import struct
+import sys
+
+MAGIC = b"KSMS"
+VERSION = 1
+STRIDE = 12
+ALIGN = 64
+HEADER = struct.Struct("<4s7I3f3f2I")
+CACHE_SIZE = 32                 # Forsyth's simulated LRU
+LINE = 64                       # vertex fetch: cache line and cache size
+FETCH_LINES = 64
+MESHLET = struct.Struct("<8f4I")
+MESHLET_VERTICES = 64
+MESHLET_TRIANGLES = 124
+
+
+# ── Vector helpers ───────────────────────────────────────────────────────────
+
+def sub(a, b):
+    return (a[0] - b[0], a[1] - b[1], a[2] - b[2])
+
+
+def cross(a, b):
+    return (a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0])
+
+
+def dot(a, b):
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]
+
+
+def normalize(a):
+    n = math.sqrt(dot(a, a))
+    return (a[0] / n, a[1] / n, a[2] / n) if n > 0 else (0.0, 1.0, 0.0)
+
+
+# ── Inputs: a triangle list of (position, normal) corners ────────────────────
+
+def smooth_normals(positions, tris):
+    """Area-weighted normal per position index for a list of index triples."""
+    acc = [[0.0, 0.0, 0.0] for _ in positions]
+    for a, b, c in tris:
+        n = cross(sub(positions[b], positions[a]), sub(positions[c], positions[a]))
+        for v in (a, b, c):
+            for k in range(3):
+                acc[v][k] += n[k]
+    return [normalize(n) for n in acc]
+
+
+def load_obj(path):
+    positions, normals, faces = [], [], []
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if not parts:
+                continue
+            if parts[0] == "v":
+                positions.append(tuple(float(x) for x in parts[1:4]))
+            elif parts[0] == "vn":
+                normals.append(tuple(float(x) for x in parts[1:4]))
+            elif parts[0] == "f":
+                poly = []
+                for ref in parts[1:]:
+                    fields = ref.split("/")
+                    v = int(fields[0])
+                    n = int(fields[2]) if len(fields) > 2 and fields[2] else 0
+                    poly.append((v - 1 if v > 0 else len(positions) + v,
+                                 n - 1 if n > 0 else len(normals) + n if n < 0 else None))
+                for i in range(1, len(poly) - 1):
+                    faces.append((poly[0], poly[i], poly[i + 1]))
+    if any(c[1] is None for tri in faces for c in tri):
+        smooth = smooth_normals(positions, [tuple(c[0] for c in tri) for tri in faces])
+        return [(positions[v], smooth[v]) for tri in faces for v, _ in tri]
+    return [(positions[v], normalize(normals[n])) for tri in faces for v, n in tri]
+
+
+COMPONENTS = {5121: "B", 5123: "H", 5125: "I", 5126: "f"}
+WIDTHS = {"SCALAR": 1, "VEC2": 2, "VEC3": 3, "VEC4": 4}
+
+
+def load_gltf(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    bin_chunk = None
+    if data[:4] == b"glTF":
+        length = struct.unpack_from("<I", data, 8)[0]
+        pos, doc = 12, None
+        while pos < length:
+            size, kind = struct.unpack_from("<II", data, pos)
+            chunk = data[pos + 8:pos + 8 + size]
+            if kind == 0x4E4F534A:
+                doc = json.loads(chunk)
+            elif kind == 0x004E4942:
+                bin_chunk = chunk
+            pos += 8 + size
+    else:
+        doc = json.loads(data)
+
+    buffers = []
+    for b in doc.get("buffers", []):
+        uri = b.get("uri")
+        if uri is None:
+            buffers.append(bin_chunk)
+        elif uri.startswith("data:"):
+            buffers.append(base64.b64decode(uri.split(",", 1)[1]))
+        else:
+            with open(os.path.join(os.path.dirname(path), uri), "rb") as f:
+                buffers.append(f.read())
+
+    def accessor(i):
+        acc = doc["accessors"][i]
+        view = doc["bufferViews"][acc["bufferView"]]
+        fmt = COMPONENTS[acc["componentType"]]
+        width = WIDTHS[acc["type"]]
+        size = struct.calcsize(fmt)
+        stride = view.get("byteStride", size * width)
+        base = view.get("byteOffset", 0) + acc.get("byteOffset", 0)
+        buf = buffers[view["buffer"]]
+        item = struct.Struct("<%d%s" % (width, fmt))
+        out = [item.unpack_from(buf, base + k * stride) for k in range(acc["count"])]
+        return [v[0] for v in out] if width == 1 else out
+
+    corners = []
+    for mesh in doc.get("meshes", []):
+        for prim in mesh["primitives"]:
+            if prim.get("mode", 4) != 4:
+                continue
+            positions = accessor(prim["attributes"]["POSITION"])
+            idx = accessor(prim["indices"]) if "indices" in prim else list(range(len(positions)))
+            tris = [tuple(idx[i:i + 3]) for i in range(0, len(idx) - 2, 3)]
+            if "NORMAL" in prim["attributes"]:
+                normals = [normalize(n) for n in accessor(prim["attributes"]["NORMAL"])]
+            else:
+                normals = smooth_normals(positions, tris)
+            corners += [(positions[v], normals[v]) for tri in tris for v in tri]
+    return corners
+
+
+# ── Built-in shapes, in [-0.5, 0.5]^3 ────────────────────────────────────────
+
+def add_tri(out, p0, p1, p2, n0, n1=None, n2=None):
+    """Counter-clockwise seen from outside, whichever way the points come."""
+    n1, n2 = n1 or n0, n2 or n0
+    if dot(cross(sub(p1, p0), sub(p2, p0)), n0) < 0:
+        p1, p2, n1, n2 = p2, p1, n2, n1
+    out += [(p0, n0), (p1, n1), (p2, n2)]
+
+
+def face_point(axis, sign, u, v):
+    p = [0.0, 0.0, 0.0]
+    p[axis] = sign
+    p[(axis + 1) % 3] = u
+    p[(axis + 2) % 3] = v
+    return tuple(p)
+
+
+def shape_cube():
+    out = []
+    for axis in range(3):
+        for sign in (-1.0, 1.0):
+            n = face_point(axis, sign, 0.0, 0.0)
+            q = [tuple(0.5 * x for x in face_point(axis, sign, u, v)) for u, v in ((-1, -1), (1, -1), (1, 1), (-1, 1))]
+            add_tri(out, q[0], q[1], q[2], n)
+            add_tri(out, q[0], q[2], q[3], n)
+    return out
+
+
+def shape_prism():
+    ring = [(0.5 * math.cos(a), 0.5 * math.sin(a)) for a in (math.pi / 2, math.pi * 7 / 6, math.pi * 11 / 6)]
+    out = []
+    for y, n in ((-0.5, (0.0, -1.0, 0.0)), (0.5, (0.0, 1.0, 0.0))):
+        add_tri(out, *[(x, y, z) for x, z in ring], n)
+    for i in range(3):
+        (x0, z0), (x1, z1) = ring[i], ring[(i + 1) % 3]
+        n = normalize((x0 + x1, 0.0, z0 + z1))
+        a, b, c, d = (x0, -0.5, z0), (x1, -0.5, z1), (x1, 0.5, z1), (x0, 0.5, z0)
+        add_tri(out, a, b, c, n)
+        add_tri(out, a, c, d, n)
+    return out
+
+
+def shape_rounded_cube(segments, radius):
+    """Each face a segments x segments grid pushed out onto a rounded box."""
+    inner = 0.5 - radius
+
+    def rounded(p):
+        core = tuple(max(-inner, min(inner, x)) for x in p)
+        n = normalize(sub(p, core))
+        return tuple(c + radius * k for c, k in zip(core, n)), n
+
+    out = []
+    for axis in range(3):
+        for sign in (-1.0, 1.0):
+            grid = [[rounded(tuple(0.5 * x for x in face_point(axis, sign, -1 + 2 * i / segments, -1 + 2 * j / segments)))
+                     for j in range(segments + 1)] for i in range(segments + 1)]
+            for i in range(segments):
+                for j in range(segments):
+                    (a, na), (b, nb), (c, nc), (d, nd) = grid[i][j], grid[i + 1][j], grid[i + 1][j + 1], grid[i][j + 1]
+                    add_tri(out, a, b, c, na, nb, nc)
+                    add_tri(out, a, c, d, na, nc, nd)
+    return out
+
+
+# ── Processing ───────────────────────────────────────────────────────────────
+
+def fit_unit_cube(corners):
+    lo = [min(p[k] for p, _ in corners) for k in range(3)]
+    hi = [max(p[k] for p, _ in corners) for k in range(3)]
+    extent = max(h - l for l, h in zip(lo, hi)) or 1.0
+    centre = [(l + h) / 2 for l, h in zip(lo, hi)]
+    return [(tuple((p[k] - centre[k]) / extent for k in range(3)), n) for p, n in corners]
+
+
+def half_bits(x):
+    return struct.unpack("<H", struct.pack("<e", x))[0]
+
+
+def half_value(bits):
+    return struct.unpack("<e", struct.pack("<H", bits))[0]
+
+
+def pack_normal(n):
+    """GL_INT_2_10_10_10_REV snorm, w = 0."""
+    bits = 0
+    for k in range(3):
+        bits |= (int(round(max(-1.0, min(1.0, n[k])) * 511)) & 0x3FF) << (10 * k)
+    return bits
+
+
+def quantize(corners):
+    """Vertices as (half bits x3, packed normal), merged where the bits match,
+    and the index list; triangles that collapse are dropped."""
+    verts, lookup, indices = [], {}, []
+    for p, n in corners:
+        key = (half_bits(p[0]), half_bits(p[1]), half_bits(p[2]), pack_normal(n))
+        if key not in lookup:
+            lookup[key] = len(verts)
+            verts.append(key)
+        indices.append(lookup[key])
+    tris = [indices[i:i + 3] for i in range(0, len(indices), 3)]
+    return verts, [v for t in tris if len(set(t)) == 3 for v in t]
+
+
+def forsyth_order(indices, vertex_count):
+    """Tom Forsyth's linear-speed vertex cache optimisation: repeatedly emit
+    the best-scoring triangle among those using vertices in a simulated LRU
+    cache, where recently used vertices and vertices with few triangles left
+    score highest."""
+    tri_count = len(indices) // 3
+    vert_tris = [[] for _ in range(vertex_count)]
+    for t in range(tri_count):
+        for v in indices[3 * t:3 * t + 3]:
+            vert_tris[v].append(t)
+    cache_pos = [-1] * vertex_count
+
+    def vertex_score(v):
+        left = len(vert_tris[v])
+        if left == 0:
+            return -1.0
+        pos, score = cache_pos[v], 0.0
+        if pos >= 0:
+            score = 0.75 if pos < 3 else (1.0 - (pos - 3) / (CACHE_SIZE - 3)) ** 1.5
+        return score + 2.0 * left ** -0.5
+
+    vscore = [vertex_score(v) for v in range(vertex_count)]
+    tscore = [sum(vscore[v] for v in indices[3 * t:3 * t + 3]) for t in range(tri_count)]
+    emitted = [False] * tri_count
+    cache, out = [], []
+    best = max(range(tri_count), key=lambda t: tscore[t]) if tri_count else -1
+    cursor = 0
+    for _ in range(tri_count):
+        if best < 0:                    # dead end: next triangle in input order
+            while emitted[cursor]:
+                cursor += 1
+            best = cursor
+        tri = indices[3 * best:3 * best + 3]
+        out += tri
+        emitted[best] = True
+        for v in tri:
+            vert_tris[v].remove(best)
+        cache = tri + [v for v in cache if v not in tri]
+        evicted, cache = cache[CACHE_SIZE:], cache[:CACHE_SIZE]
+        for v in evicted:
+            cache_pos[v] = -1
+        for i, v in enumerate(cache):
+            cache_pos[v] = i
+        for v in cache + evicted:
+            vscore[v] = vertex_score(v)
+        best, best_score = -1, -1.0
+        for v in cache + evicted:
+            for t in vert_tris[v]:
+                tscore[t] = sum(vscore[u] for u in indices[3 * t:3 * t + 3])
+                if cache_pos[v] >= 0 and tscore[t] > best_score:
+                    best, best_score = t, tscore[t]
+    return out
+
+
+def tipsify_order(indices, vertex_count, cache_size):
+    """Sander, Nehab and Barczak's Tipsify: fan out around one vertex at a
+    time, then move to the neighbour that is still in a cache_size FIFO
+    and has the most triangles left; dead ends restart from a recently
+    used vertex with triangles left, else the next unused one."""
+    tri_count = len(indices) // 3
+    vert_tris = [[] for _ in range(vertex_count)]
+    for t in range(tri_count):
+        for v in indices[3 * t:3 * t + 3]:
+            vert_tris[v].append(t)
+    live = [len(ts) for ts in vert_tris]
+    stamp = [0] * vertex_count
+    emitted = [False] * tri_count
+    dead_ends, out = [], []
+    time, cursor = cache_size + 1, 0
+
+    def skip_dead_end():
+        nonlocal cursor
+        while dead_ends:
+            v = dead_ends.pop()
+            if live[v] > 0:
+                return v
+        while cursor < vertex_count:
+            if live[cursor] > 0:
+                return cursor
+            cursor += 1
+        return -1
+
+    fan = skip_dead_end()
+    while fan >= 0:
+        ring = []
+        for t in vert_tris[fan]:
+            if emitted[t]:
+                continue
+            emitted[t] = True
+            for v in indices[3 * t:3 * t + 3]:
+                out.append(v)
+                dead_ends.append(v)
+                ring.append(v)
+                live[v] -= 1
+                if time - stamp[v] > cache_size:
+                    stamp[v] = time
+                    time += 1
+        fan, best = -1, -1
+        for v in ring:
+            if live[v] > 0:
+                # still cached after its remaining fan: the oldest such first
+                priority = time - stamp[v] if time - stamp[v] + 2 * live[v] <= cache_size else 0
+                if priority > best:
+                    fan, best = v, priority
+        if fan < 0:
+            fan = skip_dead_end()
+    return out
+
+
+def fifo_misses(indices, cache_size):
+    """Per-triangle vertex shader runs on a cache_size FIFO post-transform cache."""
+    cache, cached, misses = [], set(), []
+    for t in range(0, len(indices), 3):
+        n = 0
+        for v in indices[t:t + 3]:
+            if v not in cached:
+                n += 1
+                cache.append(v)
+                cached.add(v)
+                if len(cache) > cache_size:
+                    cached.discard(cache.pop(0))
+        misses.append(n)
+    return misses
+
+
+def overfetch(indices, vertex_count):
+    """Bytes of LINE-sized lines fetched through a FETCH_LINES LRU, per byte
+    of vertex data."""
+    lines, loaded = [], 0
+    for v in indices:
+        line = v * STRIDE // LINE
+        if line in lines:
+            lines.remove(line)
+        else:
+            loaded += 1
+            if len(lines) >= FETCH_LINES:
+                lines.pop(0)
+        lines.append(line)
+    return loaded * LINE / float(vertex_count * STRIDE)
+
+
+def overdraw_order(indices, positions, cache_size, threshold):
+    """Cluster sort: cut where every vertex of a triangle misses the cache
+    (the ordering started over there), and within those where the running
+    miss ratio from a fresh cache is within threshold of the cluster's
+    whole ratio, so cutting there costs little. Clusters are then drawn in
+    order of how far their average normal points away from the mesh
+    centre, outward facing ones first."""
+    tris = [indices[t:t + 3] for t in range(0, len(indices), 3)]
+    hard = [t for t, n in enumerate(fifo_misses(indices, cache_size)) if t == 0 or n == 3] + [len(tris)]
+    bounds = []
+    for lo, hi in zip(hard, hard[1:]):
+        run = [v for tri in tris[lo:hi] for v in tri]
+        limit = threshold * sum(fifo_misses(run, cache_size)) / (hi - lo)
+        start = lo
+        while start < hi:
+            bounds.append(start)
+            misses = 0
+            cache, cached = [], set()
+            end = start
+            while end < hi:
+                for v in tris[end]:
+                    if v not in cached:
+                        misses += 1
+                        cache.append(v)
+                        cached.add(v)
+                        if len(cache) > cache_size:
+                            cached.discard(cache.pop(0))
+                end += 1
+                if end - start >= 4 and misses <= limit * (end - start):
+                    break
+            start = end
+    bounds.append(len(tris))
+
+    def face(tri):
+        a, b, c = (positions[v] for v in tri)
+        n = cross(sub(b, a), sub(c, a))      # length is twice the area
+        return n, tuple((a[k] + b[k] + c[k]) / 3 for k in range(3))
+
+    faces = [face(tri) for tri in tris]
+    total = sum(math.sqrt(dot(n, n)) for n, _ in faces) or 1.0
+    centre = [sum(c[k] * math.sqrt(dot(n, n)) for n, c in faces) / total for k in range(3)]
+    clusters = []
+    for lo, hi in zip(bounds, bounds[1:]):
+        area = sum(math.sqrt(dot(n, n)) for n, _ in faces[lo:hi]) or 1.0
+        normal = normalize(tuple(sum(n[k] for n, _ in faces[lo:hi]) for k in range(3)))
+        mid = tuple(sum(c[k] * math.sqrt(dot(n, n)) for n, c in faces[lo:hi]) / area for k in range(3))
+        clusters.append((-dot(sub(mid, centre), normal), lo, hi))
+    clusters.sort()
+    return [v for _, lo, hi in clusters for tri in tris[lo:hi] for v in tri], len(clusters)
+
+
+def report(stage, indices, vertex_count, cache_size):
+    misses = sum(fifo_misses(indices, cache_size))
+    print("[mesh]   %-12s ACMR %.3f  ATVR %.3f  overfetch %.2f"
+          % (stage, misses / (len(indices) / 3.0), misses / float(vertex_count), overfetch(indices, vertex_count)))
+
+
+def meshlet_record(indices, positions, first, count):
+    tris = [indices[t:t + 3] for t in range(first, first + count, 3)]
+    used = sorted(set(indices[first:first + count]))
+    lo = [min(positions[v][k] for v in used) for k in range(3)]
+    hi = [max(positions[v][k] for v in used) for k in range(3)]
+    centre = tuple((l + h) / 2 for l, h in zip(lo, hi))
+    radius = max(math.sqrt(dot(sub(positions[v], centre), sub(positions[v], centre))) for v in used)
+    normals = [normalize(cross(sub(positions[b], positions[a]), sub(positions[c], positions[a]))) for a, b, c in tris]
+    axis = normalize(tuple(sum(n[k] for n in normals) for k in range(3)))
+    spread = min(dot(axis, n) for n in normals)
+    # Cone half-angle acos(spread); the eye sees only back faces inside the
+    # mirrored cone of half-angle 90 - acos(spread). Wide cones never cull.
+    cutoff = math.sqrt(max(0.0, 1.0 - spread * spread)) if spread > 0.1 else 1.0
+    return MESHLET.pack(*centre, radius, *axis, cutoff, first, count, 0, 0), cutoff < 1.0
+
+
+def build_meshlets(indices, positions, max_angle):
+    """Consecutive runs of the index list: the order already keeps triangles
+    that share vertices together, so cutting it keeps that locality."""
+    limit = math.cos(math.radians(max_angle))
+    out, cones = [], 0
+    first, used, axis = 0, set(), (0.0, 0.0, 0.0)
+    for t in range(0, len(indices) + 3, 3):
+        tri = indices[t:t + 3]
+        if tri:
+            a, b, c = (positions[v] for v in tri)
+            n = normalize(cross(sub(b, a), sub(c, a)))
+            fresh = len(set(tri) - used)
+            turned = t > first and dot(n, normalize(axis)) < limit
+        if not tri or len(used) + fresh > MESHLET_VERTICES or (t - first) // 3 >= MESHLET_TRIANGLES or turned:
+            record, cone = meshlet_record(indices, positions, first, t - first)
+            out.append(record)
+            cones += cone
+            first, used, axis = t, set(), (0.0, 0.0, 0.0)
+        if tri:
+            used |= set(tri)
+            axis = tuple(x + y for x, y in zip(axis, n))
+    return out, cones
+
+
+def renumber(verts, indices):
+    """Vertices in first-use order, so the index stream walks memory forwards."""
+    remap = {}
+    for v in indices:
+        if v not in remap:
+            remap[v] = len(remap)
+    order = sorted(remap, key=remap.get)
+    return [verts[v] for v in order], [remap[v] for v in indices]
+
+
+def pad(blob, align=ALIGN):
+    return blob + b"\0" * (-len(blob) % align)
+
+
+def write_ksm(path, verts, indices, meshlets):
+    index_size = 2 if len(verts) <= 65536 else 4
+    vertex_blob = b"".join(struct.pack("<3HHI", hx, hy, hz, 0, n) for hx, hy, hz, n in verts)
+    index_blob = struct.pack("<%d%s" % (len(indices), "H" if index_size == 2 else "I"), *indices)
+    positions = [tuple(half_value(h) for h in v[:3]) for v in verts]
+    lo = [min(p[k] for p in positions) for k in range(3)]
+    hi = [max(p[k] for p in positions) for k in range(3)]
+    vertex_offset = ALIGN
+    index_offset = vertex_offset + len(pad(vertex_blob))
+    meshlet_offset = index_offset + len(pad(index_blob)) if meshlets else 0
+    header = HEADER.pack(MAGIC, VERSION, len(verts), len(indices), STRIDE, index_size,
+                         vertex_offset, index_offset, *lo, *hi, len(meshlets), meshlet_offset)
+    blob = pad(header) + pad(vertex_blob) + index_blob
+    if meshlets:
+        blob = pad(blob) + b"".join(meshlets)
+    with open(path, "wb") as f:
+        f.write(blob)
+    return index_size, len(blob)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("input", nargs="?", help=".obj, .gltf or .glb file")
+    ap.add_argument("--shape", choices=["cube", "prism", "rounded-cube"], help="generate a built-in shape instead")
+    ap.add_argument("--segments", type=int, default=6, help="rounded-cube: grid cells along each face edge")
+    ap.add_argument("--radius", type=float, default=0.12, help="rounded-cube: edge radius, the cube being 1 across")
+    ap.add_argument("--no-fit", action="store_true", help="keep the input's own position and scale")
+    ap.add_argument("--order", choices=["forsyth", "tipsify", "input"], default="tipsify",
+                    help="vertex cache ordering (default tipsify)")
+    ap.add_argument("--cache", type=int, default=16, help="post-transform cache entries for tipsify and the stats")
+    ap.add_argument("--overdraw", type=float, default=1.05,
+                    help="cluster cut threshold, as a ratio to the cluster's cache miss rate (0: no overdraw sort)")
+    ap.add_argument("--meshlet-angle", type=float, default=45,
+                    help="start a new meshlet where a face turns this many degrees from the run's normal")
+    ap.add_argument("--no-meshlets", action="store_true", help="write no meshlet section")
+    ap.add_argument("-o", "--out", required=True, help="output .ksm file")
+    args = ap.parse_args()
+
+    if bool(args.input) == bool(args.shape):
+        ap.error("give an input file or --shape, not both")
+    if args.shape == "cube":
+        corners, name = shape_cube(), "cube"
+    elif args.shape == "prism":
+        corners, name = shape_prism(), "prism"
+    elif args.shape == "rounded-cube":
+        if args.segments < 1 or not 0 < args.radius <= 0.5:
+            ap.error("need --segments >= 1 and 0 < --radius <= 0.5")
+        corners, name = shape_rounded_cube(args.segments, args.radius), "rounded-cube"
+    else:
+        ext = os.path.splitext(args.input)[1].lower()
+        try:
+            corners = load_obj(args.input) if ext == ".obj" else load_gltf(args.input)
+        except (OSError, ValueError, KeyError, IndexError, struct.error) as e:
+            print("[mesh] cannot read %s: %s" % (args.input, e), file=sys.stderr)
+            return 1
+        name = args.input
+    if not corners:
+        print("[mesh] %s has no triangles" % name, file=sys.stderr)
+        return 1
+
+    if not args.no_fit:
+        corners = fit_unit_cube(corners)
+    verts, indices = quantize(corners)
+    if not indices:
+        print("[mesh] %s: every triangle collapsed when quantized" % name, file=sys.stderr)
+        return 1
+    if args.cache < 3:
+        ap.error("need --cache >= 3")
+    report("input", indices, len(verts), args.cache)
+    if args.order != "input":
+        if args.order == "forsyth":
+            indices = forsyth_order(indices, len(verts))
+        else:
+            indices = tipsify_order(indices, len(verts), args.cache)
+        report(args.order, indices, len(verts), args.cache)
+    if args.overdraw > 0:
+        positions = [tuple(half_value(h) for h in v[:3]) for v in verts]
+        indices, clusters = overdraw_order(indices, positions, args.cache, args.overdraw)
+        report("%d cluster%s" % (clusters, "" if clusters == 1 else "s"), indices, len(verts), args.cache)
+    verts, indices = renumber(verts, indices)
+    report("fetch order", indices, len(verts), args.cache)
+    meshlets = []
+    if not args.no_meshlets:
+        positions = [tuple(half_value(h) for h in v[:3]) for v in verts]
+        meshlets, cones = build_meshlets(indices, positions, args.meshlet_angle)
+        print("[mesh]   %d meshlets, %.1f triangles each, %d with a normal cone narrow enough to cull"
+              % (len(meshlets), len(indices) / 3.0 / len(meshlets), cones))
+    index_size, size = write_ksm(args.out, verts, indices, meshlets)
+    print("[mesh] %s: %d corners -> %d vertices, %d triangles, %d-bit indices, %d bytes -> %s"
+          % (name, len(corners), len(verts), len(indices) // 3, index_size * 8, size, args.out))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
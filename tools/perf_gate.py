@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""Performance regression gate for the kinetic sculpture.
+
+Runs the headless benchmark (--bench) several times for every combination of
+grid size and light count, then compares the per-run CPU frame times with a
+stored baseline. A configuration fails only when it is slower with
+statistical significance (one-sided Mann-Whitney U test) and by more than
+--min-slowdown; a bootstrap confidence interval of the median ratio is
+reported alongside. Results go to a JSON report.
+
+    tools/perf_gate.py --exe ./kinetic --update-baseline     # record baseline
+    tools/perf_gate.py --exe ./kinetic                       # gate: exit 1 on regression
+
+Exit codes: 0 pass, 1 significant slowdown, 2 benchmark or baseline error.
+"""
+
+import argparse
+import itertools
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+
+def run_bench(exe, frames, grid, lights, extra, timeout):
+    """One benchmark process; returns its JSON summary."""
+    fd, path = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    try:
+        cmd = [exe, "--bench", str(frames), "--grid", str(grid), "--lights", str(lights),
+               "--bench-json", path] + extra
+        subprocess.run(cmd, check=True, timeout=timeout, stdout=subprocess.DEVNULL)
+        with open(path) as f:
+            return json.load(f)
+    finally:
+        os.unlink(path)
+
+
+def median(xs):
+    s = sorted(xs)
+    n = len(s)
+    return s[n // 2] if n % 2 else 0.5 * (s[n // 2 - 1] + s[n // 2])
+
+
+def mann_whitney_greater(cur, base):
+    """One-sided p-value that cur tends to be larger than base.
+
+    Exact null distribution for small samples without ties, normal
+    approximation with tie and continuity correction otherwise."""
+    n1, n2 = len(cur), len(base)
+    pooled = sorted((v, i < n1) for i, v in enumerate(cur + base))
+    ranks = [0.0] * len(pooled)
+    ties = []
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        if j > i:
+            ties.append(j - i + 1)
+        i = j + 1
+    r1 = sum(r for r, (_, is_cur) in zip(ranks, pooled) if is_cur)
+    u = r1 - n1 * (n1 + 1) / 2.0
+
+    if not ties and n1 * n2 <= 400:
+        # counts[u] = number of orderings with statistic u, built up one
+        # observation at a time
+        table = {(0, 0): [1]}
+
+        def dist(a, b):
+            if (a, b) in table:
+                return table[(a, b)]
+            out = [0] * (a * b + 1)
+            if a:
+                for k, c in enumerate(dist(a - 1, b)):
+                    out[k + b] += c
+            if b:
+                for k, c in enumerate(dist(a, b - 1)):
+                    out[k] += c
+            table[(a, b)] = out
+            return out
+
+        counts = dist(n1, n2)
+        return sum(counts[int(u):]) / float(sum(counts))
+
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    tie_term = sum(t ** 3 - t for t in ties) / float(n * (n - 1))
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term)
+    if var <= 0:
+        return 1.0
+    z = (u - mean - 0.5) / math.sqrt(var)
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def bootstrap_ratio_ci(cur, base, rounds=2000, level=0.95, seed=1):
+    """Percentile bootstrap interval of median(cur) / median(base)."""
+    rng = random.Random(seed)
+    ratios = []
+    for _ in range(rounds):
+        c = [rng.choice(cur) for _ in cur]
+        b = [rng.choice(base) for _ in base]
+        ratios.append(median(c) / median(b))
+    ratios.sort()
+    lo = ratios[int((1 - level) / 2 * rounds)]
+    hi = ratios[min(rounds - 1, int((1 + level) / 2 * rounds))]
+    return lo, hi
+
+
+def config_key(grid, lights, extra):
+    key = "grid=%d,lights=%d" % (grid, lights)
+    return key + (",args=" + " ".join(extra) if extra else "")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--exe", required=True, help="sculpture executable")
+    ap.add_argument("--runs", type=int, default=5, help="benchmark processes per configuration")
+    ap.add_argument("--frames", type=int, default=300, help="frames per benchmark run")
+    ap.add_argument("--grids", default="10,100,1000")
+    ap.add_argument("--lights", default="4,64,256")
+    ap.add_argument("--extra", default="", help="more options for every run, e.g. \"--aa taa\"")
+    ap.add_argument("--baseline", default="perf_baseline.json")
+    ap.add_argument("--update-baseline", action="store_true", help="store this run as the baseline")
+    ap.add_argument("--report", default="perf_report.json")
+    ap.add_argument("--alpha", type=float, default=0.05, help="significance level")
+    ap.add_argument("--min-slowdown", type=float, default=0.03,
+                    help="ignore significant slowdowns smaller than this fraction")
+    ap.add_argument("--timeout", type=float, default=1800, help="seconds per benchmark run")
+    args = ap.parse_args()
+
+    grids = [int(g) for g in args.grids.split(",")]
+    lights = [int(n) for n in args.lights.split(",")]
+    extra = args.extra.split()
+
+    results = {}
+    for grid, nl in itertools.product(grids, lights):
+        key = config_key(grid, nl, extra)
+        samples, runs = [], []
+        for r in range(args.runs):
+            try:
+                out = run_bench(args.exe, args.frames, grid, nl, extra, args.timeout)
+            except (subprocess.SubprocessError, OSError, ValueError) as e:
+                print("[gate] %s run %d failed: %s" % (key, r + 1, e), file=sys.stderr)
+                return 2
+            samples.append(out["cpu_ms"])
+            runs.append(out)
+        print("[gate] %-32s median %.3f ms/frame over %d runs" % (key, median(samples), len(samples)))
+        results[key] = {"grid": grid, "lights": nl, "samples": samples, "runs": runs}
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump({"frames": args.frames, "configs": {k: {"samples": v["samples"]} for k, v in results.items()}},
+                      f, indent=2)
+        print("[gate] baseline written to %s" % args.baseline)
+        return 0
+
+    try:
+        with open(args.baseline) as f:
+            baseline = json.load(f)["configs"]
+    except (OSError, ValueError, KeyError) as e:
+        print("[gate] cannot read baseline %s: %s" % (args.baseline, e), file=sys.stderr)
+        return 2
+
+    report = {"alpha": args.alpha, "min_slowdown": args.min_slowdown, "frames": args.frames, "configs": []}
+    failed = 0
+    for key, res in results.items():
+        entry = {"config": key, "grid": res["grid"], "lights": res["lights"], "current": res["samples"]}
+        base = baseline.get(key, {}).get("samples")
+        if not base:
+            entry["verdict"] = "no-baseline"
+        else:
+            cur = res["samples"]
+            ratio = median(cur) / median(base)
+            p = mann_whitney_greater(cur, base)
+            lo, hi = bootstrap_ratio_ci(cur, base)
+            slower = p < args.alpha and ratio > 1.0 + args.min_slowdown
+            entry.update({"baseline": base, "median_ratio": ratio, "ratio_ci95": [lo, hi], "p_slower": p,
+                          "verdict": "regression" if slower else "ok"})
+            failed += slower
+            print("[gate] %-32s %+6.1f%% (95%% CI %+.1f%% .. %+.1f%%), p = %.4f: %s"
+                  % (key, (ratio - 1) * 100, (lo - 1) * 100, (hi - 1) * 100, p, entry["verdict"]))
+        report["configs"].append(entry)
+
+    report["regressions"] = failed
+    with open(args.report, "w") as f:
+        json.dump(report, f, indent=2)
+    print("[gate] %d regression(s); report written to %s" % (failed, args.report))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""Scaling curves from a tools/sweep.py CSV.
+
+Draws one SVG chart of a metric (cpu_ms by default) against one swept
+parameter, with a curve for every combination of the other parameters that
+vary; runs of the same point are reduced to their median. Axes go
+logarithmic when the data spans more than a decade. For each curve the
+log-log slope between neighbouring points is printed, and the knee (the
+point after which the slope rises the most, if by at least 0.25) is marked
+on the chart.
+
+    tools/plot_sweep.py sweep.csv --x grid
+    tools/plot_sweep.py sweep.csv --x lights --y p95_ms --out lights.svg
+
+No plotting libraries are needed; the output is plain SVG.
+"""
+
+import argparse
+import csv
+import math
+import sys
+from collections import defaultdict
+
+PARAMS = ["grid", "lights", "pixels", "mode"]
+COLOURS = ["#1f77b4", "#d62728", "#2ca02c", "#ff7f0e", "#9467bd", "#8c564b", "#e377c2", "#17becf",
+           "#7f7f7f", "#bcbd22"]
+KNEE_MIN = 0.25     # smallest slope increase reported as a knee
+W, H = 820, 520
+LEFT, RIGHT, TOP, BOTTOM = 70, 230, 40, 50
+
+
+def median(xs):
+    s = sorted(xs)
+    n = len(s)
+    return s[n // 2] if n % 2 else 0.5 * (s[n // 2 - 1] + s[n // 2])
+
+
+class Axis:
+    def __init__(self, lo, hi, pix0, pix1, log):
+        self.log = log and lo > 0
+        if self.log:
+            lo, hi = math.log10(lo), math.log10(hi)
+        if hi <= lo:
+            lo, hi = lo - 0.5, hi + 0.5
+        pad = (hi - lo) * 0.05
+        self.lo, self.hi, self.p0, self.p1 = lo - pad, hi + pad, pix0, pix1
+
+    def __call__(self, v):
+        v = math.log10(v) if self.log else v
+        return self.p0 + (v - self.lo) / (self.hi - self.lo) * (self.p1 - self.p0)
+
+    def ticks(self):
+        if self.log:
+            out = []
+            for e in range(int(math.floor(self.lo)), int(math.ceil(self.hi)) + 1):
+                for m in (1, 2, 5):
+                    v = m * 10.0 ** e
+                    if self.lo <= math.log10(v) <= self.hi:
+                        out.append(v)
+            return out
+        step = 10.0 ** math.floor(math.log10((self.hi - self.lo) / 5))
+        for m in (1, 2, 5, 10):
+            if (self.hi - self.lo) / (step * m) <= 8:
+                step *= m
+                break
+        v = math.ceil(self.lo / step) * step
+        out = []
+        while v <= self.hi:
+            out.append(v)
+            v += step
+        return out
+
+
+def fmt(v):
+    if v >= 1e6:
+        return "%gM" % (v / 1e6)
+    if v >= 1e4:
+        return "%gk" % (v / 1e3)
+    return "%g" % float("%.3g" % v)
+
+
+def sort_key(key):
+    """Numeric parameters in numeric order, mode names after them."""
+    return [(0, float(v), "") if v.replace(".", "", 1).isdigit() else (1, 0.0, v) for v in key]
+
+
+def knee(points):
+    """Log-log slopes between neighbours, and the x after which the slope grows most."""
+    slopes = []
+    for (x0, y0), (x1, y1) in zip(points, points[1:]):
+        if x0 > 0 and x1 > x0 and y0 > 0 and y1 > 0:
+            slopes.append(math.log(y1 / y0) / math.log(x1 / x0))
+        else:
+            slopes.append(float("nan"))
+    best, at = KNEE_MIN, None
+    for i in range(1, len(slopes)):
+        jump = slopes[i] - slopes[i - 1]
+        if jump > best:
+            best, at = jump, i
+    return slopes, (points[at] if at is not None else None)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("csv")
+    ap.add_argument("--x", default="grid", choices=["grid", "lights", "pixels"])
+    ap.add_argument("--y", default="cpu_ms", help="metric column, e.g. cpu_ms, gpu_ms, p95_ms, draws")
+    ap.add_argument("--out", help="SVG file (default: <csv>_<x>_<y>.svg)")
+    ap.add_argument("--linear", action="store_true", help="never use log axes")
+    args = ap.parse_args()
+
+    with open(args.csv, newline="") as f:
+        rows = list(csv.DictReader(f))
+    if not rows:
+        print("[plot] %s has no rows" % args.csv, file=sys.stderr)
+        return 2
+    if args.y not in rows[0]:
+        print("[plot] no column %s in %s" % (args.y, args.csv), file=sys.stderr)
+        return 2
+
+    # Curves are keyed by the parameters that vary, other than x
+    varying = [p for p in PARAMS if p != args.x and len({r[p] for r in rows}) > 1]
+    fixed = [p for p in PARAMS if p != args.x and p not in varying]
+    samples = defaultdict(list)
+    for r in rows:
+        key = tuple(r[p] for p in varying)
+        samples[(key, float(r[args.x]))].append(float(r[args.y]))
+    curves = defaultdict(list)
+    for (key, x), ys in samples.items():
+        curves[key].append((x, median(ys)))
+    for key in curves:
+        curves[key].sort()
+
+    xs = [x for pts in curves.values() for x, _ in pts]
+    ys = [y for pts in curves.values() for _, y in pts]
+    logx = not args.linear and min(xs) > 0 and max(xs) / min(xs) > 10
+    logy = not args.linear and min(ys) > 0 and max(ys) / min(ys) > 10
+    ax = Axis(min(xs), max(xs), LEFT, W - RIGHT, logx)
+    ay = Axis(min(ys), max(ys), H - BOTTOM, TOP, logy)
+
+    title = "%s vs %s" % (args.y, args.x)
+    if fixed:
+        title += " (" + ", ".join("%s %s" % (p, rows[0][p]) for p in fixed) + ")"
+    svg = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="sans-serif" font-size="12">'
+           % (W, H),
+           '<rect width="100%" height="100%" fill="white"/>',
+           '<text x="%d" y="22" font-size="15">%s</text>' % (LEFT, title)]
+    for v in ax.ticks():
+        px = ax(v)
+        svg.append('<line x1="%.1f" y1="%d" x2="%.1f" y2="%d" stroke="#ddd"/>' % (px, TOP, px, H - BOTTOM))
+        svg.append('<text x="%.1f" y="%d" text-anchor="middle">%s</text>' % (px, H - BOTTOM + 16, fmt(v)))
+    for v in ay.ticks():
+        py = ay(v)
+        svg.append('<line x1="%d" y1="%.1f" x2="%d" y2="%.1f" stroke="#ddd"/>' % (LEFT, py, W - RIGHT, py))
+        svg.append('<text x="%d" y="%.1f" text-anchor="end">%s</text>' % (LEFT - 6, py + 4, fmt(v)))
+    svg.append('<rect x="%d" y="%d" width="%d" height="%d" fill="none" stroke="black"/>'
+               % (LEFT, TOP, W - LEFT - RIGHT, H - TOP - BOTTOM))
+    svg.append('<text x="%d" y="%d" text-anchor="middle">%s%s</text>'
+               % ((LEFT + W - RIGHT) // 2, H - 12, args.x, " (log)" if ax.log else ""))
+    svg.append('<text transform="translate(16 %d) rotate(-90)" text-anchor="middle">%s%s</text>'
+               % ((TOP + H - BOTTOM) // 2, args.y, " (log)" if ay.log else ""))
+
+    for i, key in enumerate(sorted(curves, key=sort_key)):
+        pts = curves[key]
+        colour = COLOURS[i % len(COLOURS)]
+        name = ", ".join("%s %s" % (p, v) for p, v in zip(varying, key)) or args.y
+        path = " ".join("%s%.1f,%.1f" % ("M" if j == 0 else "L", ax(x), ay(y)) for j, (x, y) in enumerate(pts))
+        svg.append('<path d="%s" fill="none" stroke="%s" stroke-width="2"/>' % (path, colour))
+        for x, y in pts:
+            svg.append('<circle cx="%.1f" cy="%.1f" r="3" fill="%s"/>' % (ax(x), ay(y), colour))
+        ly = TOP + 14 + i * 18
+        svg.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="%s" stroke-width="2"/>'
+                   % (W - RIGHT + 12, ly - 4, W - RIGHT + 32, ly - 4, colour))
+        svg.append('<text x="%d" y="%d">%s</text>' % (W - RIGHT + 38, ly, name))
+
+        slopes, k = knee(pts)
+        if k:
+            svg.append('<circle cx="%.1f" cy="%.1f" r="7" fill="none" stroke="%s" stroke-width="2"/>'
+                       % (ax(k[0]), ay(k[1]), colour))
+        print("[plot] %-36s slopes %s%s" % (name, " ".join("%.2f" % s for s in slopes) or "-",
+                                            ", knee at %s = %g" % (args.x, k[0]) if k else ""))
+
+    svg.append("</svg>")
+    out = args.out or "%s_%s_%s.svg" % (args.csv.rsplit(".", 1)[0], args.x, args.y)
+    with open(out, "w") as f:
+        f.write("\n".join(svg) + "\n")
+    print("[plot] wrote %s" % out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Parameter sweep for the kinetic sculpture.
+
+Runs the headless benchmark (--bench) over the Cartesian product of grid
+sizes, light counts, window sizes and draw modes, and writes one CSV row per
+run. Rows are flushed as they finish, so an interrupted sweep keeps what it
+has measured. tools/plot_sweep.py turns the CSV into scaling curves.
+
+    tools/sweep.py --exe ./kinetic --grids 10,50,100,200 --lights 4,64 --out sweep.csv
+    tools/plot_sweep.py sweep.csv --x grid
+
+Draw modes:
+    mdi               multi-draw indirect, frustum culling (the default path)
+    mdi-nocull        multi-draw indirect, every region drawn
+    instanced         one instanced draw per visible run (--no-indirect)
+    instanced-nocull  one instanced draw of the whole sculpture
+"""
+
+import argparse
+import csv
+import itertools
+import subprocess
+import sys
+
+from perf_gate import median, run_bench
+
+MODES = {
+    "mdi": [],
+    "mdi-nocull": ["--no-cull"],
+    "instanced": ["--no-indirect"],
+    "instanced-nocull": ["--no-indirect", "--no-cull"],
+}
+
+COLUMNS = ["grid", "lights", "width", "height", "pixels", "mode", "run", "cpu_ms", "gpu_ms",
+           "p50_ms", "p95_ms", "max_ms", "draws", "state_changes", "indirect"]
+
+
+def percentile(xs, q):
+    s = sorted(xs)
+    if not s:
+        return 0.0
+    return s[min(len(s) - 1, int(q * len(s)))]
+
+
+def parse_size(s):
+    w, h = s.lower().split("x")
+    return int(w), int(h)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--exe", required=True, help="sculpture executable")
+    ap.add_argument("--grids", default="10,25,50,100,200")
+    ap.add_argument("--lights", default="4,16,64,256")
+    ap.add_argument("--sizes", default="1280x720", help="window sizes, e.g. 640x360,1280x720,1920x1080")
+    ap.add_argument("--modes", default="mdi,instanced", help="comma list of: " + ", ".join(MODES))
+    ap.add_argument("--frames", type=int, default=120, help="frames per benchmark run")
+    ap.add_argument("--runs", type=int, default=1, help="benchmark processes per point")
+    ap.add_argument("--extra", default="", help="more options for every run, e.g. \"--aa taa\"")
+    ap.add_argument("--timeout", type=float, default=1800, help="seconds per benchmark run")
+    ap.add_argument("--out", default="sweep.csv")
+    args = ap.parse_args()
+
+    grids = [int(g) for g in args.grids.split(",")]
+    lights = [int(n) for n in args.lights.split(",")]
+    sizes = [parse_size(s) for s in args.sizes.split(",")]
+    modes = args.modes.split(",")
+    for m in modes:
+        if m not in MODES:
+            ap.error("unknown mode %s" % m)
+    extra = args.extra.split()
+
+    points = list(itertools.product(grids, lights, sizes, modes))
+    failed = 0
+    with open(args.out, "w", newline="") as f:
+        out = csv.writer(f)
+        out.writerow(COLUMNS)
+        for n, (grid, nl, (w, h), mode) in enumerate(points, 1):
+            label = "grid %d, %d lights, %dx%d, %s" % (grid, nl, w, h, mode)
+            cpu = []
+            for r in range(args.runs):
+                opts = ["--size", "%dx%d" % (w, h)] + MODES[mode] + extra
+                try:
+                    res = run_bench(args.exe, args.frames, grid, nl, opts, args.timeout)
+                except (subprocess.SubprocessError, OSError, ValueError) as e:
+                    print("[sweep] %s run %d failed: %s" % (label, r + 1, e), file=sys.stderr)
+                    failed += 1
+                    continue
+                ft = res.get("frame_ms", [])
+                out.writerow([grid, nl, w, h, w * h, mode, r + 1, res["cpu_ms"], res["gpu_ms"],
+                              median(ft) if ft else 0.0, percentile(ft, 0.95), max(ft) if ft else 0.0,
+                              res["draws"], res["state_changes"], int(res["indirect"])])
+                f.flush()
+                cpu.append(res["cpu_ms"])
+            if cpu:
+                print("[sweep] %d/%d %-44s %.3f ms/frame" % (n, len(points), label, median(cpu)))
+
+    print("[sweep] %d point(s), %d failed run(s); wrote %s" % (len(points), failed, args.out))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "fast_trig.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WAVE_SSE 1
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  CPU heightfield wave solver
+//  Damped 2-D wave equation, leapfrog integrated at a fixed rate. The field is
+//  split into TILE x TILE blocks, each stored with its own one-cell halo, so a
+//  step is two fork-join phases: copy halos from neighbour tiles, then run the
+//  5-point stencil over every tile independently (4-wide SSE where available).
+//  Domain edges reflect.
+// ─────────────────────────────────────────────────────────────────────────────
+class WaveSolver {
+public:
+    static const int TILE = 64;
+
+    WaveSolver(int n, WorkerPool& pool, float rateHz = 120.f)
+        : n(n), pool(pool), stepDt(1.f / rateHz)
+    {
+        tilesX = (n + TILE - 1) / TILE;
+        for (int ty = 0; ty < tilesX; ty++)
+            for (int tx = 0; tx < tilesX; tx++) {
+                Tile t;
+                t.x0 = tx * TILE; t.y0 = ty * TILE;
+                t.w = std::min(TILE, n - t.x0); t.h = std::min(TILE, n - t.y0);
+                t.prev.assign((t.w + 2) * (t.h + 2), 0.f);
+                t.cur.assign((t.w + 2) * (t.h + 2), 0.f);
+                tiles.push_back(std::move(t));
+            }
+    }
+
+    int   size() const { return n; }
+    float rate() const { return 1.f / stepDt; }
+    float time() const { return simTime; }
+
+    // Runs as many fixed steps as have accumulated; drops the backlog rather
+    // than spiralling when the CPU cannot keep up.
+    int advance(float dt)
+    {
+        acc += dt;
+        int steps = 0;
+        while (acc >= stepDt && steps < MAX_STEPS) { step(); acc -= stepDt; steps++; }
+        if (steps == MAX_STEPS) acc = 0;
+        return steps;
+    }
+
+    void step()
+    {
+        pool.parallelFor(0, (int)tiles.size(), [&](int lo, int hi, unsigned) {
+            for (int i = lo; i < hi; i++) exchangeHalo(i);
+        });
+        pool.parallelFor(0, (int)tiles.size(), [&](int lo, int hi, unsigned) {
+            for (int i = lo; i < hi; i++) stepTile(tiles[i]);
+        });
+        simTime += stepDt;
+        drive();
+    }
+
+    // Gaussian bump at normalized (u, v) with zero initial velocity.
+    void drop(float u, float v, float radius, float height)
+    {
+        float cx = u * (n - 1), cy = v * (n - 1), r = radius * n;
+        int x0 = std::max(0, (int)(cx - 3 * r)), x1 = std::min(n - 1, (int)(cx + 3 * r));
+        int y0 = std::max(0, (int)(cy - 3 * r)), y1 = std::min(n - 1, (int)(cy + 3 * r));
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++) {
+                float dx = x - cx, dy = y - cy;
+                float h = height * expf(-(dx * dx + dy * dy) / (r * r));
+                Tile& t = tileAt(x, y);
+                int k = index(t, x, y);
+                t.cur[k] += h; t.prev[k] += h;
+            }
+    }
+
+    // Bilinear height at normalized (u, v) in [0,1]^2.
+    float sample(float u, float v) const
+    {
+        float fx = std::clamp(u, 0.f, 1.f) * (n - 1), fy = std::clamp(v, 0.f, 1.f) * (n - 1);
+        int x = std::min((int)fx, n - 2), y = std::min((int)fy, n - 2);
+        float ax = fx - x, ay = fy - y;
+        float a = at(x, y), b = at(x + 1, y), c = at(x, y + 1), d = at(x + 1, y + 1);
+        return (a + (b - a) * ax) * (1 - ay) + (c + (d - c) * ax) * ay;
+    }
+
+private:
+    struct Tile {
+        int x0, y0, w, h;
+        std::vector<float> prev, cur;   // (w+2) x (h+2), interior starts at (1,1)
+    };
+
+    static const int MAX_STEPS = 8;
+    static constexpr float C2 = 0.25f;      // (c*dt/dx)^2, stable below 0.5
+    static constexpr float DAMP = 0.995f;
+
+    Tile&       tileAt(int x, int y) { return tiles[(y / TILE) * tilesX + x / TILE]; }
+    const Tile& tileAt(int x, int y) const { return tiles[(y / TILE) * tilesX + x / TILE]; }
+    static int  index(const Tile& t, int x, int y) { return (y - t.y0 + 1) * (t.w + 2) + (x - t.x0 + 1); }
+    float       at(int x, int y) const { const Tile& t = tileAt(x, y); return t.cur[index(t, x, y)]; }
+
+    void exchangeHalo(int i)
+    {
+        Tile& t = tiles[i];
+        int tx = i % tilesX, ty = i / tilesX, W = t.w + 2;
+        float* c = t.cur.data();
+
+        // Rows: copy the facing edge row of the neighbour, or our own edge.
+        const float* top = ty > 0 ? rowPtr(tiles[i - tilesX], tiles[i - tilesX].h) : c + W + 1;
+        const float* bot = ty < tilesX - 1 ? rowPtr(tiles[i + tilesX], 1) : c + t.h * W + 1;
+        std::copy(top, top + t.w, c + 1);
+        std::copy(bot, bot + t.w, c + (t.h + 1) * W + 1);
+
+        // Columns
+        const Tile* l = tx > 0 ? &tiles[i - 1] : nullptr;
+        const Tile* r = tx < tilesX - 1 ? &tiles[i + 1] : nullptr;
+        for (int y = 1; y <= t.h; y++) {
+            c[y * W] = l ? l->cur[y * (l->w + 2) + l->w] : c[y * W + 1];
+            c[y * W + t.w + 1] = r ? r->cur[y * (r->w + 2) + 1] : c[y * W + t.w];
+        }
+    }
+
+    static const float* rowPtr(const Tile& t, int y) { return t.cur.data() + y * (t.w + 2) + 1; }
+
+    static void stepTile(Tile& t)
+    {
+        int W = t.w + 2;
+        for (int y = 1; y <= t.h; y++) {
+            float* p = t.prev.data() + y * W + 1;
+            const float* c = t.cur.data() + y * W + 1;
+            stepRow(p, c, c - W, c + W, t.w);
+        }
+        t.prev.swap(t.cur);
+    }
+
+    // next = cur + (cur - prev)*DAMP + C2*laplacian, written over prev.
+    static void stepRow(float* p, const float* c, const float* up, const float* dn, int w)
+    {
+        int x = 0;
+#ifdef WAVE_SSE
+        const __m128 vd = _mm_set1_ps(DAMP), vc = _mm_set1_ps(C2), v4 = _mm_set1_ps(4.f);
+        for (; x + 4 <= w; x += 4) {
+            __m128 cc = _mm_loadu_ps(c + x);
+            __m128 nb = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(c + x - 1), _mm_loadu_ps(c + x + 1)),
+                                   _mm_add_ps(_mm_loadu_ps(up + x), _mm_loadu_ps(dn + x)));
+            __m128 lap = _mm_sub_ps(nb, _mm_mul_ps(v4, cc));
+            __m128 vel = _mm_mul_ps(_mm_sub_ps(cc, _mm_loadu_ps(p + x)), vd);
+            _mm_storeu_ps(p + x, _mm_add_ps(_mm_add_ps(cc, vel), _mm_mul_ps(vc, lap)));
+        }
+#endif
+        for (; x < w; x++) {
+            float lap = c[x - 1] + c[x + 1] + up[x] + dn[x] - 4.f * c[x];
+            p[x] = c[x] + (c[x] - p[x]) * DAMP + C2 * lap;
+        }
+    }
+
+    // Oscillating disc at the centre keeps the sculpture moving without input.
+    void drive()
+    {
+        int r = std::max(1, n / 96), c = n / 2;
+        float h = fast::sin(-simTime * 2.f);
+        for (int y = c - r; y <= c + r; y++)
+            for (int x = c - r; x <= c + r; x++)
+                if ((x - c) * (x - c) + (y - c) * (y - c) <= r * r) {
+                    Tile& t = tileAt(x, y);
+                    t.cur[index(t, x, y)] = h;
+                }
+    }
+
+    int n, tilesX;
+    WorkerPool& pool;
+    std::vector<Tile> tiles;
+    float stepDt, acc = 0, simTime = 0;
+};
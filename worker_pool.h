@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cpu_topology.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Fork-join worker pool
+//  run(fn) calls fn(i) once for every participant i in [0, size()) — the
+//  calling thread is participant 0 — and returns when all of them are done.
+//  Only one thread may call run() at a time. Workers can be pinned to CPUs
+//  (see CpuTopology::placement); w's parallelFor slice is then always run on
+//  the same CPU, so data first written by w stays on w's node. The caller
+//  is never pinned: threads it starts later would inherit the mask.
+// ─────────────────────────────────────────────────────────────────────────────
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned n = 0)
+    {
+        if (n == 0) n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < n; i++)
+            threads.emplace_back([this, i] { loop(i); });
+    }
+
+    // One participant per entry, worker i pinned to cpus[i]. cpus[0] is the
+    // CPU kept for the calling thread, which stays unpinned. Empty: unpinned,
+    // one per hardware thread.
+    explicit WorkerPool(const std::vector<int>& cpus) : WorkerPool((unsigned)cpus.size())
+    {
+        if (cpus.empty()) return;
+        cpu = cpus;
+        for (size_t i = 1; i < cpus.size(); i++) failed += !pinThread(threads[i - 1].native_handle(), cpus[i]);
+    }
+
+    ~WorkerPool()
+    {
+        { std::lock_guard<std::mutex> l(m); quit = true; }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const { return (unsigned)threads.size() + 1; }
+    int  cpuOf(unsigned w) const { return w < cpu.size() ? cpu[w] : -1; }    // -1: not pinned; w = 0 is never pinned, its CPU is only kept free
+    bool pinned() const { return !cpu.empty() && failed == 0; }
+    unsigned pinFailures() const { return failed; }
+
+    void run(const std::function<void(unsigned)>& fn)
+    {
+        if (threads.empty()) { fn(0); return; }
+        {
+            std::lock_guard<std::mutex> l(m);
+            job = &fn;
+            pending = (unsigned)threads.size();
+            ++gen;
+        }
+        wake.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> l(m);
+        done.wait(l, [&] { return pending == 0; });
+        job = nullptr;
+    }
+
+    // Splits [begin, end) into one contiguous slice per participant and calls
+    // fn(lo, hi, worker) for every non-empty slice.
+    template <class F>
+    void parallelFor(int begin, int end, F&& fn)
+    {
+        long long n = end - begin, p = size();
+        run([&](unsigned w) {
+            int lo = begin + (int)(n * w / p);
+            int hi = begin + (int)(n * (w + 1) / p);
+            if (lo < hi) fn(lo, hi, w);
+        });
+    }
+
+private:
+    void loop(unsigned i)
+    {
+        unsigned seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* f;
+            {
+                std::unique_lock<std::mutex> l(m);
+                wake.wait(l, [&] { return quit || gen != seen; });
+                if (quit) return;
+                seen = gen;
+                f = job;
+            }
+            (*f)(i);
+            std::lock_guard<std::mutex> l(m);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable wake, done;
+    const std::function<void(unsigned)>* job = nullptr;
+    unsigned pending = 0, gen = 0;
+    bool quit = false;
+    std::vector<int> cpu;       // per participant, when pinned
+    unsigned failed = 0;
+};